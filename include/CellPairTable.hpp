@@ -0,0 +1,106 @@
+#ifndef CELL_PAIR_TABLE_HPP
+#define CELL_PAIR_TABLE_HPP
+
+#include "includes_file.hpp"
+#include "GeometryCache.hpp"
+#include "ReferenceShapes.hpp"
+
+#include <optional>
+
+using namespace dealii;
+
+// ==================================================================
+// Class: CellPairTable
+//
+// Description:
+//   Compact table of the locally owned cells of a mesh carrying two
+//   DoF handlers (velocity and pressure), built once after the DoFs
+//   are distributed. For every owned cell it stores the iterators of
+//   both handlers, the global DoF indices of both fields, and the
+//   affine geometry of the simplex (see CellGeometry).
+//
+//   As in GeometryCache, the geometry is only stored with
+//   store_geometry; otherwise it is recomputed from the vertices at
+//   each access.
+//
+//   The assemblers loop over this table instead of walking both
+//   handlers side by side and reinitializing two FEValues objects on
+//   every cell, including the non-owned ones.
+// ==================================================================
+template <int dim>
+class CellPairTable
+{
+public:
+    struct CellData
+    {
+        typename DoFHandler<dim>::active_cell_iterator velocity_cell;    // Cell of the velocity handler
+
+        typename DoFHandler<dim>::active_cell_iterator pressure_cell;    // Same cell in the pressure handler
+
+        std::vector<types::global_dof_index> velocity_dof_indices;       // Global velocity DoFs of the cell
+
+        std::vector<types::global_dof_index> pressure_dof_indices;       // Global pressure DoFs of the cell
+
+        std::optional<CellGeometry<dim>> stored_geometry;                // Affine map from the reference simplex (if stored)
+
+        CellGeometry<dim> geometry() const
+        {
+            return stored_geometry ? *stored_geometry : CellGeometry<dim>::compute(velocity_cell);
+        }
+    };
+
+    // Build the table from two handlers distributed on the same mesh.
+    void reinit(const DoFHandler<dim> &dof_handler_velocity,
+                const DoFHandler<dim> &dof_handler_pressure,
+                const bool store_geometry)
+    {
+        cells.clear();
+
+        auto cell_v = dof_handler_velocity.begin_active();
+        auto cell_p = dof_handler_pressure.begin_active();
+        const auto end_v = dof_handler_velocity.end();
+
+        for (; cell_v != end_v; ++cell_v, ++cell_p)
+        {
+            if (!cell_v->is_locally_owned())
+                continue;
+
+            CellData data;
+            data.velocity_cell = cell_v;
+            data.pressure_cell = cell_p;
+
+            data.velocity_dof_indices.resize(cell_v->get_fe().dofs_per_cell);
+            data.pressure_dof_indices.resize(cell_p->get_fe().dofs_per_cell);
+            cell_v->get_dof_indices(data.velocity_dof_indices);
+            cell_p->get_dof_indices(data.pressure_dof_indices);
+
+            if (store_geometry)
+                data.stored_geometry = CellGeometry<dim>::compute(cell_v);
+            else
+                AssertThrow(cell_v->reference_cell().is_simplex(),
+                            ExcMessage("CellPairTable requires a simplex mesh."));
+
+            cells.push_back(std::move(data));
+        }
+    }
+
+    unsigned int size() const
+    {
+        return cells.size();
+    }
+
+    typename std::vector<CellData>::const_iterator begin() const
+    {
+        return cells.begin();
+    }
+
+    typename std::vector<CellData>::const_iterator end() const
+    {
+        return cells.end();
+    }
+
+private:
+    std::vector<CellData> cells;                                // Locally owned cells
+};
+
+#endif
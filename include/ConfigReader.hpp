@@ -6,11 +6,14 @@
 #include <unordered_set>
 #include <filesystem>
 
+#include "SolverOptions.hpp"
+
 /*
     ConfigReader Class
     ------------------
     * Loads simulation config (mesh paths, polynomial degrees, simulation period, time step, Reynolds number) using regex and filesystem.
     * Validates all required parameters and prompts user if any are missing.
+    * Reads the optional solver settings (probes, ...), which keep their defaults when missing.
     * Provides public getters for easy access to these configuration values.
     ------------------
 */
@@ -19,6 +22,7 @@
 class ConfigReader
 {
 private:
+    std::filesystem::path configFilePath;                       ///< Path to the config file
     std::filesystem::path mesh2DPath;                           ///< Path to the 2D mesh
     std::filesystem::path mesh3DPath;                           ///< Path to the 3D mesh
     int degreeVelocity = 0;                                     ///< Degree of polynomial for velocity
@@ -26,6 +30,9 @@ private:
     double simulationPeriod = 0.0;                              ///< Simulation period (T)
     double timeStep = 0.0;                                      ///< Time step (deltat)
     double Re = 0.0;                                            ///< Reynolds number
+    std::filesystem::path probes2DPath;                         ///< Path to the 2D probes file (optional)
+    std::filesystem::path probes3DPath;                         ///< Path to the 3D probes file (optional)
+    SolverOptions solverOptions{};                              ///< Optional solver settings
     std::regex pattern{};                                       ///< Regular expression for parsing config
     std::unordered_set<std::string> requiredVariables = {};     ///< Required variables
 
@@ -34,7 +41,7 @@ private:
     auto promptUserForVariable(const std::string& variableName)         -> void;
 
 public:
-    ConfigReader();
+    ConfigReader(const std::filesystem::path &configFilePath_ = "../parameters.config");
 
     auto getMesh2DPath() const        -> std::filesystem::path;
     auto getMesh3DPath() const        -> std::filesystem::path;
@@ -44,6 +51,9 @@ public:
     auto getTimeStep() const          -> double;
     auto readConfigFile()             -> bool;
     auto getRe() const                -> double;
+    auto getProbes2DPath() const      -> std::filesystem::path;
+    auto getProbes3DPath() const      -> std::filesystem::path;
+    auto getSolverOptions() const     -> SolverOptions;
     };
 
 #endif 
\ No newline at end of file
@@ -0,0 +1,160 @@
+#ifndef CONVECTION_BATCH_HPP
+#define CONVECTION_BATCH_HPP
+
+#include "includes_file.hpp"
+#include "ReferenceShapes.hpp"
+
+using namespace dealii;
+
+// ==================================================================
+// Class: ConvectionBatch
+//
+// Description:
+//   This class assembles the velocity-velocity part of the momentum
+//   matrix
+//
+//       C_ij = ∫ m φ_i·φ_j + ν ∇φ_i:∇φ_j + ((u*·∇)φ_j)·φ_i
+//                + s (∇·u*) φ_i·φ_j dx
+//
+//   for a batch of n_lanes cells at once. The velocity space is a
+//   vector of copies of the same scalar element, so every term only
+//   couples equal components and reduces to a scalar matrix on the
+//   shape functions ϕ_a of the scalar element:
+//
+//       C_ab = Σ_q JxW (ϕ_a (m ϕ_b + ∇ϕ_b·u* + s (∇·u*) ϕ_b) + ν ∇ϕ_a·∇ϕ_b),
+//
+//   which is dim^2 times cheaper than the vector-valued form. The
+//   data of the batch is stored with the cell index (lane) as the
+//   fastest running index, so the arithmetic kernel applies the same
+//   operation to all the cells of the batch and is vectorized across
+//   cells. The kernel is compiled for AVX-512, AVX2 and generic x86-64
+//   and the variant is selected at run time from the CPU features. It is
+//   also instantiated with compile-time sizes for P1 and P2 velocities,
+//   with a generic fallback for the other degrees.
+//
+//   Usage: add_cell() for up to n_lanes cells, compute(), then
+//   distribute() the matrix of each lane to its cell matrix.
+// ==================================================================
+
+// Number of cells per batch: one AVX-512 register of doubles, two AVX2 registers.
+constexpr unsigned int convection_batch_lanes = 8;
+
+// Arithmetic kernel of ConvectionBatch (see src/ConvectionBatch.cpp). It
+// dispatches to a version compiled for the given (dim, n_scalar_dofs) if
+// one exists, and to the generic version otherwise.
+void convection_batch_kernel(const unsigned int n_scalar_dofs,
+                             const unsigned int n_q,
+                             const unsigned int dim,
+                             const double mass_coefficient,
+                             const double viscosity,
+                             const double skew_coefficient,
+                             const double *values,
+                             const double *gradients,
+                             const double *advection,
+                             const double *divergence,
+                             const double *JxW,
+                             double *trial,
+                             double *matrices);
+
+// Instruction set and version of the kernel used for a velocity of the given degree on this CPU.
+std::string convection_batch_kernel_name(const unsigned int dim, const unsigned int degree);
+
+template <int dim>
+class ConvectionBatch
+{
+public:
+    static constexpr unsigned int n_lanes = convection_batch_lanes;
+
+    // ............................................................
+    // Constructor
+    // ............................................................
+    // Parameters:
+    //   fe                  - finite element, whose velocity components are copies of one scalar element.
+    //   n_q_                - number of quadrature points.
+    //   first_component_    - first velocity component of fe.
+    //   mass_coefficient_   - coefficient m of the mass term.
+    //   viscosity_          - coefficient ν of the viscous term.
+    //   skew_coefficient_   - coefficient s of the (∇·u*) term.
+    // ............................................................
+    ConvectionBatch(const FiniteElement<dim> &fe,
+                    const unsigned int &n_q_,
+                    const unsigned int &first_component_,
+                    const double &mass_coefficient_,
+                    const double &viscosity_,
+                    const double &skew_coefficient_);
+
+    // Copy the shape functions of the cell fe_values was reinitialized on,
+    // and the advection field at the quadrature points, into the next lane.
+    void add_cell(const FEValues<dim> &fe_values,
+                  const std::vector<Tensor<1, dim>> &advection_values,
+                  const std::vector<double> &advection_divergences);
+
+    // Same as above, for a simplex with the given affine geometry, with the
+    // shape functions of the element the batch was built for precomputed
+    // at the quadrature points.
+    void add_cell(const ReferenceShapes<dim> &shapes,
+                  const Tensor<2, dim> &inverse_jacobian,
+                  const double &jacobian_determinant,
+                  const std::vector<Tensor<1, dim>> &advection_values,
+                  const std::vector<double> &advection_divergences);
+
+    // Number of cells in the batch.
+    unsigned int size() const
+    {
+        return n_cells;
+    }
+
+    bool full() const
+    {
+        return n_cells == n_lanes;
+    }
+
+    // Compute the matrices of all the cells in the batch.
+    void compute();
+
+    // Add the matrix of the given lane to the velocity-velocity entries of cell_matrix.
+    void distribute(const unsigned int &lane, FullMatrix<double> &cell_matrix) const;
+
+    // Empty the batch.
+    void clear()
+    {
+        n_cells = 0;
+    }
+
+private:
+    const unsigned int n_q;                                     // Number of quadrature points
+
+    const unsigned int first_component;                         // First velocity component of the finite element
+
+    const double mass_coefficient;                              // Coefficient of the mass term
+
+    const double viscosity;                                     // Coefficient of the viscous term
+
+    const double skew_coefficient;                              // Coefficient of the (∇·u*) term
+
+    std::vector<unsigned int> scalar_dofs;                      // Cell dof of each scalar shape function, in the first velocity component
+
+    std::vector<unsigned int> velocity_dofs;                    // Cell dofs of the velocity components
+
+    std::vector<unsigned int> velocity_dof_component;           // Velocity component of each entry of velocity_dofs
+
+    std::vector<unsigned int> velocity_dof_scalar_index;        // Scalar shape function of each entry of velocity_dofs
+
+    unsigned int n_cells;                                       // Cells in the batch
+
+    std::vector<double> values;                                 // ϕ_a(x_q),        [q][a][lane]
+
+    std::vector<double> gradients;                              // ∇ϕ_a(x_q),       [q][a][d][lane]
+
+    std::vector<double> advection;                              // u*(x_q),         [q][d][lane]
+
+    std::vector<double> divergence;                             // ∇·u*(x_q),       [q][lane]
+
+    std::vector<double> JxW;                                    // Quadrature weights, [q][lane]
+
+    std::vector<double> trial;                                  // Kernel workspace, [a][lane]
+
+    std::vector<double> matrices;                               // C_ab,            [a][b][lane]
+};
+
+#endif
@@ -0,0 +1,175 @@
+#ifndef GEOMETRY_CACHE_HPP
+#define GEOMETRY_CACHE_HPP
+
+#include "includes_file.hpp"
+
+#include <algorithm>
+
+using namespace dealii;
+
+// ==================================================================
+// Struct: CellGeometry
+//
+// Description:
+//   Geometry of a simplex cell under the affine map x = v_0 + J x̂
+//   from the reference simplex. The Jacobian is constant on the cell,
+//   so this is all FEValues would compute on it: reference gradients
+//   map to the cell with J^{-T}, JxW = w_q |det J|, and quadrature
+//   points map with quadrature_point().
+// ==================================================================
+template <int dim>
+struct CellGeometry
+{
+    Point<dim> origin;                                          // v_0, image of the origin of the reference cell
+
+    Tensor<2, dim> jacobian;                                    // J, whose columns are the edges from v_0
+
+    Tensor<2, dim> inverse_jacobian;                            // J^{-T}
+
+    double jacobian_determinant;                                // |det J|
+
+    double diameter;                                            // Cell diameter
+
+    // Compute the geometry of a simplex cell from its vertices.
+    template <class CellIterator>
+    static CellGeometry<dim> compute(const CellIterator &cell)
+    {
+        AssertThrow(cell->reference_cell().is_simplex(),
+                    ExcMessage("CellGeometry requires a simplex mesh."));
+
+        CellGeometry<dim> geometry;
+        geometry.origin = cell->vertex(0);
+        for (unsigned int k = 0; k < dim; ++k)
+            for (unsigned int d = 0; d < dim; ++d)
+                geometry.jacobian[d][k] = cell->vertex(k + 1)[d] - cell->vertex(0)[d];
+
+        geometry.inverse_jacobian = transpose(invert(geometry.jacobian));
+        geometry.jacobian_determinant = std::abs(determinant(geometry.jacobian));
+        geometry.diameter = cell->diameter();
+
+        return geometry;
+    }
+
+    // Point of the cell corresponding to a point of the reference cell.
+    Point<dim> quadrature_point(const Point<dim> &reference_point) const
+    {
+        return origin + jacobian * reference_point;
+    }
+};
+
+// ==================================================================
+// Class: GeometryCache
+//
+// Description:
+//   Locally owned cells of a DoF handler on a mesh that does not
+//   change during the run, with their global DoF indices and their
+//   geometry, built once after the DoFs are distributed. The
+//   assemblers loop over it instead of the handler and evaluate the
+//   shape functions with ReferenceShapes, so no FEValues::reinit is
+//   needed on cell integrals.
+//
+//   The cells whose DoFs are all owned (interior cells) come first,
+//   followed by those touching DoFs of other processes, so that an
+//   assembler can process the interior cells while the ghost values
+//   of its input vectors are still being exchanged.
+//
+//   With store_geometry the CellGeometry of every cell is kept
+//   (2 dim^2 + dim + 2 doubles per cell); otherwise it is recomputed
+//   from the vertices at each access, which is still much cheaper
+//   than a FEValues::reinit.
+// ==================================================================
+template <int dim>
+class GeometryCache
+{
+public:
+    // Build the cache for the owned cells of dof_handler.
+    void reinit(const DoFHandler<dim> &dof_handler, const bool store_geometry)
+    {
+        cells.clear();
+        dof_indices.clear();
+        geometries.clear();
+
+        const IndexSet &owned_dofs = dof_handler.locally_owned_dofs();
+        std::vector<types::global_dof_index> indices;
+
+        // Two passes over the owned cells: interior cells, then the others
+        for (const bool interior_pass : {true, false})
+        {
+            for (const auto &cell : dof_handler.active_cell_iterators())
+            {
+                if (!cell->is_locally_owned())
+                    continue;
+
+                indices.resize(cell->get_fe().dofs_per_cell);
+                cell->get_dof_indices(indices);
+
+                const bool interior = std::all_of(indices.begin(), indices.end(),
+                                                  [&](const types::global_dof_index dof) {
+                                                      return owned_dofs.is_element(dof);
+                                                  });
+                if (interior != interior_pass)
+                    continue;
+
+                cells.push_back(cell);
+                dof_indices.push_back(indices);
+
+                if (store_geometry)
+                    geometries.push_back(CellGeometry<dim>::compute(cell));
+                else
+                    AssertThrow(cell->reference_cell().is_simplex(),
+                                ExcMessage("GeometryCache requires a simplex mesh."));
+            }
+
+            if (interior_pass)
+                n_interior = cells.size();
+        }
+    }
+
+    // Number of owned cells.
+    unsigned int size() const
+    {
+        return cells.size();
+    }
+
+    // Number of interior cells, i.e. the cells [0, n_interior_cells()) whose DoFs are all owned.
+    unsigned int n_interior_cells() const
+    {
+        return n_interior;
+    }
+
+    const typename DoFHandler<dim>::active_cell_iterator &cell(const unsigned int k) const
+    {
+        return cells[k];
+    }
+
+    const std::vector<types::global_dof_index> &cell_dof_indices(const unsigned int k) const
+    {
+        return dof_indices[k];
+    }
+
+    CellGeometry<dim> geometry(const unsigned int k) const
+    {
+        return geometries.empty() ? CellGeometry<dim>::compute(cells[k]) : geometries[k];
+    }
+
+    // Memory used by the cache [bytes].
+    std::size_t memory_consumption() const
+    {
+        std::size_t bytes = cells.size() * sizeof(typename DoFHandler<dim>::active_cell_iterator) +
+                            geometries.size() * sizeof(CellGeometry<dim>);
+        for (const auto &indices : dof_indices)
+            bytes += indices.size() * sizeof(types::global_dof_index);
+        return bytes;
+    }
+
+private:
+    std::vector<typename DoFHandler<dim>::active_cell_iterator> cells;     // Owned cells
+
+    std::vector<std::vector<types::global_dof_index>> dof_indices;         // Global DoFs of each cell
+
+    std::vector<CellGeometry<dim>> geometries;                             // Geometry of each cell (empty if not stored)
+
+    unsigned int n_interior = 0;                                           // Cells whose DoFs are all owned, stored first
+};
+
+#endif
@@ -0,0 +1,156 @@
+#ifndef GHOST_EXCHANGE_HPP
+#define GHOST_EXCHANGE_HPP
+
+#include "includes_file.hpp"
+
+#include <deal.II/base/array_view.h>
+#include <deal.II/base/partitioner.h>
+
+using namespace dealii;
+
+// ---------------------------------------------------------------
+// Class: GhostExchange
+//
+// Description:
+//   Non-blocking update of a ghosted Trilinos block vector from its
+//   owned counterpart, split into start() and finish() halves so that
+//   local work can run while the ghost values are in flight. The
+//   assignment ghosted = owned of the Trilinos wrappers is a blocking
+//   Epetra import instead.
+//
+//   start() copies the owned entries (no communication) and posts the
+//   sends and receives of the ghost entries through one
+//   Utilities::MPI::Partitioner per block; finish() waits for them and
+//   writes the ghosts into the vector. In between, only the owned
+//   entries of the ghosted vector may be read.
+//
+//   The entries of a ghosted Trilinos vector are stored in the order
+//   of its locally relevant index set, and the owned range of a block
+//   is contiguous, so both copies are direct. In debug mode finish()
+//   checks the result against the blocking import.
+// ---------------------------------------------------------------
+class GhostExchange
+{
+public:
+    // Build the communication pattern of block vectors with the given
+    // owned and locally relevant indices of each block.
+    void reinit(const std::vector<IndexSet> &owned_dofs,
+                const std::vector<IndexSet> &relevant_dofs,
+                const MPI_Comm &communicator)
+    {
+        const unsigned int n_blocks = owned_dofs.size();
+
+        partitioners.resize(n_blocks);
+        import_buffers.resize(n_blocks);
+        ghost_buffers.resize(n_blocks);
+        requests.resize(n_blocks);
+        owned_offsets.assign(n_blocks, 0);
+        ghost_positions.resize(n_blocks);
+        relevant_index_sets = relevant_dofs;
+
+        for (unsigned int b = 0; b < n_blocks; ++b)
+        {
+            partitioners[b] = std::make_shared<Utilities::MPI::Partitioner>(owned_dofs[b],
+                                                                            relevant_dofs[b],
+                                                                            communicator);
+
+            import_buffers[b].resize(partitioners[b]->n_import_indices());
+            ghost_buffers[b].resize(partitioners[b]->n_ghost_indices());
+
+            if (owned_dofs[b].n_elements() > 0)
+                owned_offsets[b] = relevant_dofs[b].index_within_set(*owned_dofs[b].begin());
+
+            ghost_positions[b].clear();
+            for (const types::global_dof_index dof : partitioners[b]->ghost_indices())
+                ghost_positions[b].push_back(relevant_dofs[b].index_within_set(dof));
+        }
+    }
+
+    // Copy the owned entries of owned_vector into ghosted_vector and start
+    // the exchange of its ghost entries. owned_vector must not change
+    // until finish().
+    void start(const TrilinosWrappers::MPI::BlockVector &owned_vector,
+               TrilinosWrappers::MPI::BlockVector &ghosted_vector)
+    {
+        AssertThrow(!in_flight, ExcMessage("A ghost exchange is already in progress."));
+
+        source = &owned_vector;
+        target = &ghosted_vector;
+
+        for (unsigned int b = 0; b < partitioners.size(); ++b)
+        {
+            const double *owned_values = owned_vector.block(b).begin();
+            const unsigned int n_owned = owned_vector.block(b).end() - owned_vector.block(b).begin();
+
+            std::copy(owned_values, owned_values + n_owned, ghosted_vector.block(b).begin() + owned_offsets[b]);
+
+            partitioners[b]->export_to_ghosted_array_start<double>(b,
+                                                                  ArrayView<const double>(owned_values, n_owned),
+                                                                  make_array_view(import_buffers[b]),
+                                                                  make_array_view(ghost_buffers[b]),
+                                                                  requests[b]);
+        }
+
+        in_flight = true;
+    }
+
+    // Wait for the ghost entries and write them into the vector passed to
+    // start(). Does nothing if no exchange is in progress.
+    void finish()
+    {
+        if (!in_flight)
+            return;
+
+        for (unsigned int b = 0; b < partitioners.size(); ++b)
+        {
+            partitioners[b]->export_to_ghosted_array_finish<double>(make_array_view(ghost_buffers[b]),
+                                                                   requests[b]);
+
+            double *values = target->block(b).begin();
+            for (unsigned int k = 0; k < ghost_positions[b].size(); ++k)
+                values[ghost_positions[b][k]] = ghost_buffers[b][k];
+        }
+
+        in_flight = false;
+
+#ifdef DEBUG
+        // The direct copies rely on the storage order of the ghosted
+        // vector: compare every relevant entry with the Epetra import.
+        TrilinosWrappers::MPI::BlockVector reference(*target);
+        reference = *source;
+        for (unsigned int b = 0; b < partitioners.size(); ++b)
+            for (const types::global_dof_index dof : relevant_index_sets[b])
+                Assert(target->block(b)(dof) == reference.block(b)(dof),
+                       ExcMessage("GhostExchange does not match the import of the owned vector."));
+#endif
+    }
+
+    // True between start() and finish().
+    bool pending() const
+    {
+        return in_flight;
+    }
+
+private:
+    std::vector<std::shared_ptr<const Utilities::MPI::Partitioner>> partitioners; // Communication pattern of each block
+
+    std::vector<std::vector<double>> import_buffers;            // Owned entries sent to other processes
+
+    std::vector<std::vector<double>> ghost_buffers;             // Ghost entries received, in the order of the ghost index set
+
+    std::vector<std::vector<MPI_Request>> requests;             // Pending sends and receives of each block
+
+    std::vector<unsigned int> owned_offsets;                    // Position of the first owned entry in the ghosted storage
+
+    std::vector<std::vector<unsigned int>> ghost_positions;     // Position of each ghost entry in the ghosted storage
+
+    std::vector<IndexSet> relevant_index_sets;                  // Locally relevant indices of each block
+
+    const TrilinosWrappers::MPI::BlockVector *source = nullptr; // Owned vector being exchanged
+
+    TrilinosWrappers::MPI::BlockVector *target = nullptr;       // Vector being updated
+
+    bool in_flight = false;                                     // Exchange started and not finished
+};
+
+#endif
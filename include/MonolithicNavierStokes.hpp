@@ -2,8 +2,17 @@
 #define MONOLITHICNAVIERSTOKES_HPP
 
 #include "includes_file.hpp"
+#include "Probes.hpp"
+#include "SolverOptions.hpp"
+#include "SolutionHistory.hpp"
+#include "GeometryCache.hpp"
+#include "GhostExchange.hpp"
+#include "ReferenceShapes.hpp"
+#include "SparseDirectSolver.hpp"
 using namespace dealii;
 
+class BlockPrecondition;
+
 // ==================================================================
 // Class: MonolithicNavierStokes
 //
@@ -11,7 +20,9 @@ using namespace dealii;
 //   This class solves the incompressible Navier-Stokes equations
 //   using a monolithic approach. The class is templated on the
 //   dimensionality of the problem in order to handle 2D and 3D
-//   problems.
+//   problems. Time is discretized with BDF1 (backward Euler) or
+//   BDF2 with extrapolated convection u* = 2u^n - u^{n-1}; BDF2
+//   takes its first step with BDF1.
 //
 //  =================================================================
 
@@ -93,6 +104,7 @@ public:
     //   T_ - final time.
     //   deltat_ - time step.
     //   re_ - Reynolds number.
+    //   options_ - optional run-time settings.
     // ............................................................
 
     MonolithicNavierStokes(
@@ -101,7 +113,8 @@ public:
         const unsigned int &degree_pressure_,
         const double &T_,
         const double &deltat_,
-        const double &re_)
+        const double &re_,
+        const SolverOptions &options_ = SolverOptions())
         : mpi_size(Utilities::MPI::n_mpi_processes(MPI_COMM_WORLD))
         , mpi_rank(Utilities::MPI::this_mpi_process(MPI_COMM_WORLD))
         , pcout(std::cout, mpi_rank == 0)
@@ -110,11 +123,13 @@ public:
         , reynolds_number(re_)
         , T(T_)
         , deltat(deltat_)
+        , options(options_)
         , degree_velocity(degree_velocity_)
         , degree_pressure(degree_pressure_)
         , inlet_velocity(H)
         , velocity(0) 
         , pressure(dim)
+        , solution_history(options_.extrapolation_depth, options_.projection_depth)
     {
         this->nu = (2. / 3.) * inlet_velocity.get_u_max() * cylinder_radius / reynolds_number;
     }
@@ -132,12 +147,21 @@ private:
 
     auto assemble_rhs() -> void; // Assemble the right-hand side of the problem.
 
+    auto apply_dirichlet_conditions() -> void; // Impose the cached Dirichlet conditions on the system matrix, right-hand side and initial guess.
+
     auto solve_time_step() -> void; // Group all the instructions that need to be executed at each time step.
 
+    template <typename PreconditionerType>
+    auto get_block_preconditioner() -> PreconditionerType &; // Create and configure block_precondition at the first call, then return it.
+
+    auto solve_direct() -> void; // Solve the system with the sparse direct solver, in place of the preconditioned GMRES.
+
     auto solve() -> void; // Solve the entire problem by looping over time steps.
 
     auto output(const unsigned int &time_step) -> void; // Save the output of the computation in a pvtk format.
 
+    auto report_memory() const -> void; // Print the memory used by the matrices and vectors of the linear system.
+
     auto get_output_directory() const -> std::string; // Defines the path of the directory where the outputs will be stored
 
 
@@ -179,6 +203,13 @@ private:
 
     double time;                                            // Current time.
 
+    unsigned int bdf_order;                                 // Order of the BDF scheme used in the current step.
+
+    // ================================
+    // Optional Settings
+
+    const SolverOptions options;                            // Optional run-time settings.
+
     // ================================
     // Finite Element and Discretization
 
@@ -192,6 +223,14 @@ private:
 
     std::unique_ptr<Quadrature<dim - 1>> quadrature_face;   // Quadrature formula for boundary.
 
+    std::vector<unsigned int> velocity_cell_dofs;           // Cell-local indices of the velocity shape functions.
+
+    std::vector<unsigned int> pressure_cell_dofs;           // Cell-local indices of the pressure shape functions.
+
+    ReferenceShapes<dim> shapes;                            // Shape functions at the quadrature points of the reference cell.
+
+    GeometryCache<dim> geometry_cache;                      // Owned cells with their DoFs and geometry (the mesh is fixed).
+
     // ================================
     // Degrees of Freedom (DoFs) and Constraints
 
@@ -207,11 +246,17 @@ private:
 
     AffineConstraints<double> constraints;                  // Affine constraints.
 
+    AffineConstraints<double> pressure_outflow_constraints; // Outflow Dirichlet conditions of the pressure operators (pressure block numbering).
+
     // ================================
     // Boundary and Initial Conditions
 
     InletVelocity inlet_velocity;                           // Inlet velocity.
 
+    std::vector<types::global_dof_index> dirichlet_dofs;    // Owned velocity DoFs on the inlet, walls and obstacle.
+
+    std::vector<double> dirichlet_values;                   // Their boundary values (time independent).
+
     Functions::ZeroFunction<dim> forcing_term;              // Forcing term.
 
     const bool zero_forcing = 0;                            // Indicator for zero forcing term.
@@ -232,19 +277,55 @@ private:
     // ================================
     // System Matrices and Vectors
 
-    TrilinosWrappers::BlockSparseMatrix system_matrix;      // Time-independent matrix.
+    // Only the lhs matrix is a block matrix: the other operators live on
+    // a single block and share its sparsity pattern.
+
+    TrilinosWrappers::BlockSparseMatrix lhs_matrix;         // Complete system matrix (pressure blocks assembled once).
 
-    TrilinosWrappers::BlockSparseMatrix velocity_mass;      // Velocity mass matrix.
+    TrilinosWrappers::SparseMatrix stiffness_matrix;        // Time-independent part of the momentum block.
 
-    TrilinosWrappers::BlockSparseMatrix pressure_mass;      // Pressure mass matrix.
+    TrilinosWrappers::SparseMatrix velocity_mass;           // Velocity mass matrix.
 
-    TrilinosWrappers::BlockSparseMatrix lhs_matrix;         // Complete system matrix.
+    TrilinosWrappers::SparseMatrix pressure_mass;           // Pressure mass matrix.
+
+    TrilinosWrappers::SparseMatrix pressure_laplace;        // Pressure Laplacian (PCD and Cahouet-Chabard only).
+
+    TrilinosWrappers::SparseMatrix pressure_convection_diffusion; // Pressure convection-diffusion operator (PCD only).
 
     TrilinosWrappers::MPI::BlockVector system_rhs;          // Right-hand side vector.
 
     TrilinosWrappers::MPI::BlockVector solution_owned;      // System solution without ghosts.
 
     TrilinosWrappers::MPI::BlockVector solution;            // System solution with ghosts.
+
+    TrilinosWrappers::MPI::BlockVector solution_old;        // Solution at the previous time step, with ghosts (BDF2).
+
+    SolutionHistory<TrilinosWrappers::MPI::BlockVector> solution_history; // Past solutions used for the GMRES initial guess.
+
+    std::shared_ptr<BlockPrecondition> block_precondition;  // Block preconditioner, kept across time steps.
+
+    GhostExchange ghost_exchange;                           // Non-blocking update of the ghosts of solution after each solve.
+
+    DoFHandler<dim> dof_handler_coarse;                     // P1 velocity DoFs, coarse level of the velocity p-multigrid.
+
+    TrilinosWrappers::SparseMatrix velocity_prolongation;   // Interpolation from the P1 velocity space to the velocity block.
+
+    TrilinosWrappers::SparseMatrix direct_matrix;           // Copy of lhs_matrix as a single matrix (direct solver only).
+
+    TrilinosWrappers::MPI::Vector direct_rhs;               // Copy of system_rhs as a single vector (direct solver only).
+
+    TrilinosWrappers::MPI::Vector direct_solution;          // Solution of the direct solve, without ghosts.
+
+    SparseDirectSolver direct_solver;                       // Factorization of direct_matrix, with the analysis of the first step.
+
+    // ================================
+    // Post-Processing
+
+    std::unique_ptr<Probes<dim>> probes;                    // Point probes (null if not requested).
+
+    double convective_assembly_time = 0.0;                  // Wall time spent in add_convective_term() [s].
+
+    unsigned long n_convective_cells = 0;                   // Cells assembled by add_convective_term().
 };
 
 #endif
\ No newline at end of file
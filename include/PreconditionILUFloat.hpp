@@ -0,0 +1,161 @@
+#ifndef PRECONDITION_ILU_FLOAT_HPP
+#define PRECONDITION_ILU_FLOAT_HPP
+
+#include "includes_file.hpp"
+
+#include <algorithm>
+
+using namespace dealii;
+
+// ---------------------------------------------------------------
+// Class: PreconditionILUFloat
+//
+// Description:
+//   Incomplete LU factorization without fill-in, ILU(0), of the
+//   locally owned diagonal block of a Trilinos matrix, stored and
+//   applied in single precision. Like TrilinosWrappers::PreconditionILU
+//   with its default settings, the couplings with the DoFs of other
+//   processes are dropped (block Jacobi between processes), so the
+//   application needs no communication.
+//
+//   The factorization is computed in double precision and rounded
+//   once; the triangular solves read float factors and 32-bit column
+//   indices, which roughly halves the memory traffic of an
+//   application. Vectors are converted at the boundary, so the outer
+//   solvers keep working in double precision.
+// ---------------------------------------------------------------
+class PreconditionILUFloat : public TrilinosWrappers::PreconditionBase
+{
+public:
+    // Compute the factorization of the owned block of matrix.
+    void initialize(const TrilinosWrappers::SparseMatrix &matrix)
+    {
+        const Epetra_CrsMatrix &epetra_matrix = matrix.trilinos_matrix();
+        const Epetra_Map &row_map = epetra_matrix.RowMap();
+        const Epetra_Map &column_map = epetra_matrix.ColMap();
+
+        n_rows = epetra_matrix.NumMyRows();
+
+        // Owned block, in local numbering, with sorted columns
+        row_start.assign(n_rows + 1, 0);
+        columns.clear();
+        std::vector<double> factors;
+        std::vector<std::pair<unsigned int, double>> row;
+
+        for (unsigned int i = 0; i < n_rows; ++i)
+        {
+            int n_entries;
+            double *row_values;
+            int *row_indices;
+            epetra_matrix.ExtractMyRowView(i, n_entries, row_values, row_indices);
+
+            row.clear();
+            for (int e = 0; e < n_entries; ++e)
+            {
+#ifdef DEAL_II_WITH_64BIT_INDICES
+                const int j = row_map.LID(column_map.GID64(row_indices[e]));
+#else
+                const int j = row_map.LID(column_map.GID(row_indices[e]));
+#endif
+                if (j >= 0)
+                    row.emplace_back(j, row_values[e]);
+            }
+            std::sort(row.begin(), row.end());
+
+            for (const auto &entry : row)
+            {
+                columns.push_back(entry.first);
+                factors.push_back(entry.second);
+            }
+            row_start[i + 1] = columns.size();
+        }
+
+        // ILU(0), row by row (IKJ variant): a_ik /= u_kk and
+        // a_ij -= a_ik u_kj on the pattern of row i, for k < i < j.
+        diagonal.resize(n_rows);
+        std::vector<int> position(n_rows, -1);
+
+        for (unsigned int i = 0; i < n_rows; ++i)
+        {
+            for (unsigned int p = row_start[i]; p < row_start[i + 1]; ++p)
+                position[columns[p]] = p;
+
+            AssertThrow(position[i] >= 0,
+                        ExcMessage("PreconditionILUFloat requires a nonzero diagonal."));
+            diagonal[i] = position[i];
+
+            for (unsigned int p = row_start[i]; p < diagonal[i]; ++p)
+            {
+                const unsigned int k = columns[p];
+                factors[p] /= factors[diagonal[k]];
+
+                for (unsigned int q = diagonal[k] + 1; q < row_start[k + 1]; ++q)
+                    if (position[columns[q]] >= 0)
+                        factors[position[columns[q]]] -= factors[p] * factors[q];
+            }
+
+            AssertThrow(factors[diagonal[i]] != 0.0,
+                        ExcMessage("Zero pivot in PreconditionILUFloat."));
+
+            for (unsigned int p = row_start[i]; p < row_start[i + 1]; ++p)
+                position[columns[p]] = -1;
+        }
+
+        values.assign(factors.begin(), factors.end());
+        inverse_diagonal.resize(n_rows);
+        for (unsigned int i = 0; i < n_rows; ++i)
+            inverse_diagonal[i] = static_cast<float>(1.0 / factors[diagonal[i]]);
+
+        work.resize(n_rows);
+    }
+
+    // Apply dst = (LU)^{-1} src, with L unit lower triangular.
+    void vmult(TrilinosWrappers::MPI::Vector &dst,
+               const TrilinosWrappers::MPI::Vector &src) const override
+    {
+        const double *x = src.begin();
+        double *y = dst.begin();
+
+        for (unsigned int i = 0; i < n_rows; ++i)
+        {
+            float sum = static_cast<float>(x[i]);
+            for (unsigned int p = row_start[i]; p < diagonal[i]; ++p)
+                sum -= values[p] * work[columns[p]];
+            work[i] = sum;
+        }
+
+        for (unsigned int i = n_rows; i-- > 0;)
+        {
+            float sum = work[i];
+            for (unsigned int p = diagonal[i] + 1; p < row_start[i + 1]; ++p)
+                sum -= values[p] * work[columns[p]];
+            work[i] = sum * inverse_diagonal[i];
+            y[i] = work[i];
+        }
+    }
+
+    // Memory used by the factors [bytes].
+    std::size_t memory_consumption() const
+    {
+        return values.size() * sizeof(float) + columns.size() * sizeof(unsigned int) +
+               (row_start.size() + diagonal.size()) * sizeof(unsigned int) +
+               (inverse_diagonal.size() + work.size()) * sizeof(float);
+    }
+
+private:
+    unsigned int n_rows = 0;                                    // Owned rows
+
+    std::vector<unsigned int> row_start;                        // First entry of each row
+
+    std::vector<unsigned int> columns;                          // Local column of each entry
+
+    std::vector<unsigned int> diagonal;                         // Diagonal entry of each row
+
+    std::vector<float> values;                                  // L (strictly lower) and U factors
+
+    std::vector<float> inverse_diagonal;                        // 1 / u_ii
+
+    mutable std::vector<float> work;                            // Intermediate solution of the triangular solves
+};
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef PRECONDITION_P_MULTIGRID_HPP
+#define PRECONDITION_P_MULTIGRID_HPP
+
+#include "includes_file.hpp"
+
+using namespace dealii;
+
+// ---------------------------------------------------------------
+// Class: PreconditionPMultigrid
+//
+// Description:
+//   Two-level polynomial multigrid V-cycle for a matrix A on a
+//   higher-order velocity space, with the P1 space on the same mesh
+//   as coarse level. With the prolongation P (interpolation of P1
+//   functions into the fine space), one application is
+//
+//       x = S^{-1} b                           (pre-smoothing)
+//       x = x + P A_1^{-1} P^T (b - A x)       (coarse correction)
+//       x = x + S^{-1} (b - A x)               (post-smoothing)
+//
+//   where A_1 = P^T A P is the Galerkin coarse matrix, computed at every
+//   initialize() since A changes, and A_1^{-1} and S^{-1} are applied by
+//   the inner preconditioners set by the caller (AMG and ILU in the
+//   block preconditioners). The AMG hierarchy is thus only built on
+//   the P1 matrix, which is much smaller and sparser than the P2 one.
+// ---------------------------------------------------------------
+class PreconditionPMultigrid : public TrilinosWrappers::PreconditionBase
+{
+public:
+    // Compute the coarse matrix P^T A P. The smoother and the coarse
+    // preconditioner must be set afterwards.
+    void initialize(const TrilinosWrappers::SparseMatrix &matrix_,
+                    const TrilinosWrappers::SparseMatrix &prolongation_)
+    {
+        matrix = &matrix_;
+        prolongation = &prolongation_;
+
+        matrix->mmult(matrix_times_prolongation, *prolongation);
+        prolongation->Tmmult(coarse_matrix, matrix_times_prolongation);
+    }
+
+    const TrilinosWrappers::SparseMatrix &get_coarse_matrix() const
+    {
+        return coarse_matrix;
+    }
+
+    // Preconditioner of the fine matrix, applied as a Richardson smoother.
+    void set_smoother(const std::shared_ptr<TrilinosWrappers::PreconditionBase> &smoother_)
+    {
+        smoother = smoother_;
+    }
+
+    // Approximate inverse of the coarse matrix.
+    void set_coarse_preconditioner(const std::shared_ptr<TrilinosWrappers::PreconditionBase> &coarse_preconditioner_)
+    {
+        coarse_preconditioner = coarse_preconditioner_;
+    }
+
+    // Apply one V-cycle to src, starting from zero.
+    void vmult(TrilinosWrappers::MPI::Vector &dst,
+               const TrilinosWrappers::MPI::Vector &src) const override
+    {
+        residual.reinit(src, true);
+        correction.reinit(src, true);
+        coarse_residual.reinit(coarse_matrix.locally_owned_range_indices(), src.get_mpi_communicator());
+        coarse_correction.reinit(coarse_residual, true);
+
+        smoother->vmult(dst, src);
+        for (unsigned int k = 1; k < n_smoothing_steps; ++k)
+            smooth(dst, src);
+
+        matrix->vmult(residual, dst);
+        residual.sadd(-1.0, 1.0, src);
+        prolongation->Tvmult(coarse_residual, residual);
+        coarse_preconditioner->vmult(coarse_correction, coarse_residual);
+        prolongation->vmult_add(dst, coarse_correction);
+
+        for (unsigned int k = 0; k < n_smoothing_steps; ++k)
+            smooth(dst, src);
+    }
+
+private:
+    // One Richardson step x += S^{-1} (b - A x).
+    void smooth(TrilinosWrappers::MPI::Vector &dst, const TrilinosWrappers::MPI::Vector &src) const
+    {
+        matrix->vmult(residual, dst);
+        residual.sadd(-1.0, 1.0, src);
+        smoother->vmult(correction, residual);
+        dst += correction;
+    }
+
+    static constexpr unsigned int n_smoothing_steps = 2;        // Pre- and post-smoothing steps
+
+    const TrilinosWrappers::SparseMatrix *matrix = nullptr;     // Fine matrix A
+
+    const TrilinosWrappers::SparseMatrix *prolongation = nullptr; // P, from the P1 space to the fine space
+
+    TrilinosWrappers::SparseMatrix matrix_times_prolongation;   // A P
+
+    TrilinosWrappers::SparseMatrix coarse_matrix;               // P^T A P
+
+    std::shared_ptr<TrilinosWrappers::PreconditionBase> smoother;              // Smoother of the fine level
+
+    std::shared_ptr<TrilinosWrappers::PreconditionBase> coarse_preconditioner; // Approximate inverse of the coarse matrix
+
+    mutable TrilinosWrappers::MPI::Vector residual;             // Fine residual
+
+    mutable TrilinosWrappers::MPI::Vector correction;           // Fine smoother correction
+
+    mutable TrilinosWrappers::MPI::Vector coarse_residual;      // Restricted residual
+
+    mutable TrilinosWrappers::MPI::Vector coarse_correction;    // Coarse correction
+};
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef PROBES_HPP
+#define PROBES_HPP
+
+#include "includes_file.hpp"
+
+using namespace dealii;
+
+// ==================================================================
+// Class: Probes
+//
+// Description:
+//   This class samples the discrete solution at a fixed set of
+//   points and streams the sampled values to a single CSV file.
+//   The probes are read from a text file where each non-comment
+//   line defines one of the following entities:
+//
+//       point x y [z]
+//       line  x0 y0 [z0]  x1 y1 [z1]  n
+//       plane ox oy [oz]  ax ay [az]  bx by [bz]  na nb
+//
+//   A line is sampled at n equispaced points between the two end
+//   points, a plane at na x nb points of o + s*a + t*b, s,t in [0,1].
+//
+//   The cells containing the probes are located once in initialize();
+//   for every probe the owning process stores the global DoF indices
+//   of the cell and the shape function values at the reference
+//   coordinates, so that sample() reduces to a small dot product per
+//   probe and a single reduction to rank 0.
+// ==================================================================
+
+template <int dim>
+class Probes
+{
+public:
+    // ............................................................
+    // Constructor
+    // ............................................................
+    // Parameters:
+    //   probes_file_name_ - name of the probe definition file.
+    // ............................................................
+    Probes(const std::string &probes_file_name_);
+
+    // Locate the probes and open the output file.
+    //
+    // Parameters:
+    //   dof_handlers_    - DoF handlers of the sampled fields (all on the same mesh).
+    //   component_names_ - names of the components of each DoF handler.
+    //   output_file_name - CSV file the samples are appended to.
+    auto initialize(const std::vector<const DoFHandler<dim> *> &dof_handlers_,
+                    const std::vector<std::vector<std::string>> &component_names_,
+                    const std::string &output_file_name) -> void;
+
+    // Evaluate the fields at the probes and write one line to the output file.
+    // The vectors must contain ghost entries and match the DoF handlers
+    // passed to initialize().
+    template <typename VectorType>
+    void sample(const double &time, const std::vector<const VectorType *> &solutions);
+
+    // Convenience overload for a single DoF handler.
+    template <typename VectorType>
+    void sample(const double &time, const VectorType &solution);
+
+    auto n_probes() const -> unsigned int // returns the number of probes
+    {return points.size();}
+
+private:
+    auto read_probes_file() -> void; // Parse the probe definition file into a list of points.
+
+    // ---------------------------------------------------------------
+    // Cached evaluation data of a probe for one DoF handler.
+    // ---------------------------------------------------------------
+    struct FieldData
+    {
+        std::vector<types::global_dof_index> dof_indices;       // Global DoFs of the owning cell
+        std::vector<unsigned int> components;                   // Component of each local shape function
+        std::vector<double> shape_values;                       // Shape function values at the probe
+    };
+
+    const std::string probes_file_name;                         // Probe definition file
+
+    const unsigned int mpi_size;                                // Number of MPI processes
+
+    const unsigned int mpi_rank;                                // This MPI process
+
+    MappingFE<dim> mapping;                                     // Linear simplex mapping used for the cell search
+
+    std::vector<Point<dim>> points;                             // Probe locations
+
+    std::vector<unsigned int> owners;                           // Process owning each probe (mpi_size = not found)
+
+    std::vector<unsigned int> component_offsets;                // First output column of each DoF handler
+
+    unsigned int n_components = 0;                              // Total number of sampled components
+
+    std::vector<std::vector<FieldData>> field_data;             // [probe][dof handler] cached evaluation data
+
+    std::vector<double> local_values;                           // Sampled values owned by this process
+
+    std::vector<double> global_values;                          // Sampled values gathered on rank 0
+
+    std::ofstream output_file;                                  // Output stream (rank 0 only)
+};
+
+#endif
@@ -0,0 +1,195 @@
+#ifndef REFERENCE_SHAPES_HPP
+#define REFERENCE_SHAPES_HPP
+
+#include "includes_file.hpp"
+
+using namespace dealii;
+
+// ==================================================================
+// Class: ReferenceShapes
+//
+// Description:
+//   Values and reference-cell gradients of the shape functions of a
+//   finite element at the points of a quadrature formula, computed
+//   once. Every shape function must be primitive (nonzero in a single
+//   component), as for FE_SimplexP and for FESystems of it.
+//
+//   On simplices the mapping is affine: the values do not depend on
+//   the cell, and the gradients are obtained from the reference ones
+//   through the inverse Jacobian of the cell (see CellGeometry). The
+//   evaluation helpers combine them with the local coefficients of a
+//   finite element function; for a mixed element they only read the
+//   shape functions of the requested components.
+// ==================================================================
+template <int dim>
+class ReferenceShapes
+{
+public:
+    // Compute the shape functions of fe at the points of quadrature.
+    void reinit(const FiniteElement<dim> &fe, const Quadrature<dim> &quadrature)
+    {
+        n_dofs = fe.dofs_per_cell;
+        weights = quadrature.get_weights();
+        points = quadrature.get_points();
+
+        components.resize(n_dofs);
+        for (unsigned int i = 0; i < n_dofs; ++i)
+        {
+            AssertThrow(fe.is_primitive(i), ExcMessage("ReferenceShapes requires primitive shape functions."));
+            components[i] = fe.system_to_component_index(i).first;
+        }
+
+        values.resize(n_q() * n_dofs);
+        gradients.resize(n_q() * n_dofs);
+        for (unsigned int q = 0; q < n_q(); ++q)
+            for (unsigned int i = 0; i < n_dofs; ++i)
+            {
+                values[q * n_dofs + i] = fe.shape_value_component(i, quadrature.point(q), components[i]);
+                gradients[q * n_dofs + i] = fe.shape_grad_component(i, quadrature.point(q), components[i]);
+            }
+    }
+
+    unsigned int n_q() const
+    {
+        return weights.size();
+    }
+
+    unsigned int dofs_per_cell() const
+    {
+        return n_dofs;
+    }
+
+    // Weight of the quadrature point on the reference cell.
+    double weight(const unsigned int q) const
+    {
+        return weights[q];
+    }
+
+    // Quadrature point on the reference cell.
+    const Point<dim> &point(const unsigned int q) const
+    {
+        return points[q];
+    }
+
+    // Component in which shape function i is nonzero.
+    unsigned int component(const unsigned int i) const
+    {
+        return components[i];
+    }
+
+    // Nonzero component of shape function i at quadrature point q.
+    double value(const unsigned int i, const unsigned int q) const
+    {
+        return values[q * n_dofs + i];
+    }
+
+    // Gradient of the nonzero component of shape function i at quadrature
+    // point q, mapped to the cell with inverse jacobian J^{-T}.
+    Tensor<1, dim> gradient(const unsigned int i, const unsigned int q, const Tensor<2, dim> &inverse_jacobian) const
+    {
+        return inverse_jacobian * gradients[q * n_dofs + i];
+    }
+
+    // Values at the quadrature points of the vector field stored in the
+    // components [first_component, first_component + dim), with local coefficients `local`.
+    void vector_values(const std::vector<double> &local,
+                       std::vector<Tensor<1, dim>> &result,
+                       const unsigned int first_component = 0) const
+    {
+        for (unsigned int q = 0; q < n_q(); ++q)
+        {
+            result[q] = 0.0;
+            for (unsigned int i = 0; i < n_dofs; ++i)
+                if (components[i] >= first_component && components[i] < first_component + dim)
+                    result[q][components[i] - first_component] += local[i] * values[q * n_dofs + i];
+        }
+    }
+
+    // Gradients at the quadrature points of the same vector field.
+    void vector_gradients(const std::vector<double> &local,
+                          const Tensor<2, dim> &inverse_jacobian,
+                          std::vector<Tensor<2, dim>> &result,
+                          const unsigned int first_component = 0) const
+    {
+        for (unsigned int q = 0; q < n_q(); ++q)
+        {
+            Tensor<2, dim> reference_gradient;
+            for (unsigned int i = 0; i < n_dofs; ++i)
+                if (components[i] >= first_component && components[i] < first_component + dim)
+                    reference_gradient[components[i] - first_component] += local[i] * gradients[q * n_dofs + i];
+            result[q] = reference_gradient * transpose(inverse_jacobian);
+        }
+    }
+
+    // Divergence at the quadrature points of the same vector field.
+    void divergences(const std::vector<double> &local,
+                     const Tensor<2, dim> &inverse_jacobian,
+                     std::vector<double> &result,
+                     const unsigned int first_component = 0) const
+    {
+        for (unsigned int q = 0; q < n_q(); ++q)
+        {
+            result[q] = 0.0;
+            for (unsigned int i = 0; i < n_dofs; ++i)
+                if (components[i] >= first_component && components[i] < first_component + dim)
+                    result[q] += local[i] * gradient(i, q, inverse_jacobian)[components[i] - first_component];
+        }
+    }
+
+    // Values at the quadrature points of the scalar field stored in `component`.
+    void scalar_values(const std::vector<double> &local,
+                       std::vector<double> &result,
+                       const unsigned int component = 0) const
+    {
+        for (unsigned int q = 0; q < n_q(); ++q)
+        {
+            result[q] = 0.0;
+            for (unsigned int i = 0; i < n_dofs; ++i)
+                if (components[i] == component)
+                    result[q] += local[i] * values[q * n_dofs + i];
+        }
+    }
+
+    // Gradients at the quadrature points of the same scalar field.
+    void scalar_gradients(const std::vector<double> &local,
+                          const Tensor<2, dim> &inverse_jacobian,
+                          std::vector<Tensor<1, dim>> &result,
+                          const unsigned int component = 0) const
+    {
+        for (unsigned int q = 0; q < n_q(); ++q)
+        {
+            Tensor<1, dim> reference_gradient;
+            for (unsigned int i = 0; i < n_dofs; ++i)
+                if (components[i] == component)
+                    reference_gradient += local[i] * gradients[q * n_dofs + i];
+            result[q] = inverse_jacobian * reference_gradient;
+        }
+    }
+
+    // Mass matrix on the reference cell, ∫ φ_i·φ_j dx̂. On a simplex the
+    // mass matrix of a cell is |det J| times it.
+    void reference_mass_matrix(FullMatrix<double> &result) const
+    {
+        result.reinit(n_dofs, n_dofs);
+        for (unsigned int q = 0; q < n_q(); ++q)
+            for (unsigned int i = 0; i < n_dofs; ++i)
+                for (unsigned int j = 0; j < n_dofs; ++j)
+                    if (components[i] == components[j])
+                        result(i, j) += weights[q] * values[q * n_dofs + i] * values[q * n_dofs + j];
+    }
+
+private:
+    unsigned int n_dofs = 0;                                    // Shape functions per cell
+
+    std::vector<double> weights;                                // Reference quadrature weights
+
+    std::vector<Point<dim>> points;                             // Reference quadrature points
+
+    std::vector<unsigned int> components;                       // Nonzero component of each shape function
+
+    std::vector<double> values;                                 // Shape values, [q][i]
+
+    std::vector<Tensor<1, dim>> gradients;                      // Reference gradients, [q][i]
+};
+
+#endif
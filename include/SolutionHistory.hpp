@@ -0,0 +1,175 @@
+#ifndef SOLUTION_HISTORY_HPP
+#define SOLUTION_HISTORY_HPP
+
+#include "includes_file.hpp"
+
+using namespace dealii;
+
+// ---------------------------------------------------------------
+// Class: SolutionHistory
+//
+// Description:
+//   This class stores the solutions of the last few linear solves of
+//   a time loop and builds the initial guess of the next Krylov solve
+//   from them. Two strategies are available:
+//
+//   - polynomial extrapolation: with depth k the guess is the value
+//     at t^{n+1} of the polynomial of degree k-1 through the last k
+//     solutions, i.e.
+//         k = 1:  x^n
+//         k = 2:  2x^n - x^{n-1}
+//         k = 3:  3x^n - 3x^{n-1} + x^{n-2}
+//
+//   - subspace projection: the guess is the vector of span{x^n, ...,
+//     x^{n-k+1}} minimizing the residual ||b - A x0||. The products
+//     A x^j are orthonormalized with modified Gram-Schmidt, so the
+//     projection costs k matrix-vector products and O(k^2) dot
+//     products per solve. Since the extrapolated guesses lie in the
+//     same span, the projected guess is never worse than them. For
+//     a periodic flow the past solutions capture the slowly varying
+//     part of the solution and the Krylov solver only has to resolve
+//     the remainder.
+//
+//   The class is templated on the vector type so that it can be used
+//   both with Trilinos vectors and block vectors.
+// ---------------------------------------------------------------
+template <typename VectorType>
+class SolutionHistory
+{
+public:
+    // Parameters:
+    //   extrapolation_depth_ - number of past solutions used by the polynomial extrapolation (0 = off, at most 3).
+    //   projection_depth_    - number of past solutions spanning the projection space (0 = off).
+    SolutionHistory(const unsigned int &extrapolation_depth_,
+                    const unsigned int &projection_depth_)
+        : extrapolation_depth(std::min(extrapolation_depth_, 3u)),
+          projection_depth(projection_depth_)
+    {
+    }
+
+    // True if the history provides an initial guess.
+    bool active() const
+    {
+        return extrapolation_depth > 0 || projection_depth > 0;
+    }
+
+    // Store the solution of the last solve, discarding the oldest one if needed.
+    void push(const VectorType &solution)
+    {
+        const unsigned int depth = std::max(extrapolation_depth, projection_depth);
+        if (depth == 0)
+            return;
+
+        if (history.size() == depth)
+        {
+            // Recycle the storage of the oldest vector.
+            history.push_front(std::move(history.back()));
+            history.pop_back();
+            history.front() = solution;
+        }
+        else
+            history.push_front(solution);
+    }
+
+    // Overwrite x0 with the initial guess for the system A x = b. The
+    // guess is left untouched if no past solution is available yet.
+    template <typename MatrixType>
+    void initial_guess(const MatrixType &A, const VectorType &b, VectorType &x0)
+    {
+        if (history.empty())
+            return;
+
+        if (projection_depth > 0)
+            project(A, b, x0);
+        else
+            extrapolate(x0);
+    }
+
+private:
+    // Polynomial extrapolation of the stored solutions.
+    void extrapolate(VectorType &x0) const
+    {
+        // Coefficients of x^n, x^{n-1}, x^{n-2} for each available depth.
+        static const double coefficients[3][3] = {{1.0, 0.0, 0.0},
+                                                  {2.0, -1.0, 0.0},
+                                                  {3.0, -3.0, 1.0}};
+
+        const unsigned int k = std::min<unsigned int>(extrapolation_depth, history.size());
+
+        x0.equ(coefficients[k - 1][0], history[0]);
+        for (unsigned int j = 1; j < k; ++j)
+            x0.add(coefficients[k - 1][j], history[j]);
+    }
+
+    // Least-squares projection of the solution onto the span of the stored solutions.
+    template <typename MatrixType>
+    void project(const MatrixType &A, const VectorType &b, VectorType &x0)
+    {
+        const unsigned int k = std::min<unsigned int>(projection_depth, history.size());
+
+        if (Ax.size() < k)
+            Ax.resize(k);
+
+        // Columns kept after the orthonormalization, with the upper
+        // triangular factor R of A X = Q R and the projections Q^T b.
+        std::vector<unsigned int> columns;
+        FullMatrix<double> R(k, k);
+        Vector<double> Qtb(k);
+
+        for (unsigned int j = 0; j < k; ++j)
+        {
+            const unsigned int c = columns.size();
+
+            Ax[c].reinit(b, true);
+            A.vmult(Ax[c], history[j]);
+
+            const double norm_before = Ax[c].l2_norm();
+            if (norm_before == 0.0)
+                continue;
+
+            for (unsigned int i = 0; i < c; ++i)
+            {
+                R(i, c) = Ax[i] * Ax[c];
+                Ax[c].add(-R(i, c), Ax[i]);
+            }
+
+            // Discard solutions that are (numerically) linearly dependent on the previous ones.
+            const double norm_after = Ax[c].l2_norm();
+            if (norm_after < 1e-10 * norm_before)
+                continue;
+
+            R(c, c) = norm_after;
+            Ax[c] /= norm_after;
+            Qtb(c) = Ax[c] * b;
+            columns.push_back(j);
+        }
+
+        if (columns.empty())
+            return;
+
+        // Back substitution R y = Q^T b.
+        const unsigned int m = columns.size();
+        Vector<double> y(m);
+        for (int i = m - 1; i >= 0; --i)
+        {
+            double value = Qtb(i);
+            for (unsigned int l = i + 1; l < m; ++l)
+                value -= R(i, l) * y(l);
+            y(i) = value / R(i, i);
+        }
+
+        x0.equ(y(0), history[columns[0]]);
+        for (unsigned int i = 1; i < m; ++i)
+            x0.add(y(i), history[columns[i]]);
+    }
+
+    const unsigned int extrapolation_depth;                     // Past solutions used by the extrapolation
+
+    const unsigned int projection_depth;                        // Past solutions spanning the projection space
+
+    std::deque<VectorType> history;                             // Past solutions, most recent first
+
+    std::vector<VectorType> Ax;                                 // Orthonormalized products A x^j (projection only)
+};
+
+#endif
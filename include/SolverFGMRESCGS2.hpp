@@ -0,0 +1,245 @@
+#ifndef SOLVER_FGMRES_CGS2_HPP
+#define SOLVER_FGMRES_CGS2_HPP
+
+#include "includes_file.hpp"
+
+using namespace dealii;
+
+// ---------------------------------------------------------------
+// Class: SolverFGMRESCGS2
+//
+// Description:
+//   Restarted flexible GMRES (right preconditioning, so the
+//   preconditioner may change between applications) whose Arnoldi
+//   basis is orthogonalized with classical Gram-Schmidt applied twice
+//   (CGS2), for Trilinos block vectors.
+//
+//   With modified Gram-Schmidt, as in SolverGMRES and SolverFGMRES,
+//   iteration j needs j + 2 global reductions: one per dot product
+//   and one for the norm. Classical Gram-Schmidt computes all the dot
+//   products of a pass from the same vector, so they are summed over
+//   the processes with a single MPI_Allreduce. The second pass restores
+//   the orthogonality that a single classical pass loses, and it
+//   also carries ||w||^2, from which the norm of the new basis vector
+//   follows by Pythagoras' theorem:
+//
+//       ||w - V c||^2 = ||w||^2 - ||c||^2.
+//
+//   Each iteration therefore costs two reductions, whatever its index.
+//   The solver counts its reductions, and the ones modified Gram-Schmidt
+//   would have needed for the same iterations.
+// ---------------------------------------------------------------
+class SolverFGMRESCGS2
+{
+public:
+    // Parameters:
+    //   solver_control_ - stopping criterion, on the residual norm.
+    //   restart_        - Krylov vectors before a restart.
+    SolverFGMRESCGS2(SolverControl &solver_control_, const unsigned int &restart_ = 30)
+        : solver_control(solver_control_), restart(restart_)
+    {
+    }
+
+    // Solve A x = b, with x as initial guess.
+    template <typename MatrixType, typename PreconditionerType>
+    void solve(const MatrixType &A,
+               TrilinosWrappers::MPI::BlockVector &x,
+               const TrilinosWrappers::MPI::BlockVector &b,
+               const PreconditionerType &preconditioner)
+    {
+        n_fused_reductions = 0;
+        n_mgs_reductions = 0;
+
+        basis.resize(restart + 1);
+        preconditioned_basis.resize(restart);
+        for (auto &v : basis)
+            v.reinit(x, true);
+        for (auto &z : preconditioned_basis)
+            z.reinit(x, true);
+
+        FullMatrix<double> hessenberg(restart + 1, restart);
+        std::vector<double> givens_cos(restart), givens_sin(restart);
+        std::vector<double> rhs(restart + 1), coefficients(restart + 1);
+
+        // Initial residual
+        A.vmult(basis[0], x);
+        basis[0].sadd(-1.0, 1.0, b);
+        double residual_norm = basis[0].l2_norm();
+        ++n_fused_reductions;
+        ++n_mgs_reductions;
+
+        unsigned int iteration = 0;
+        SolverControl::State state = solver_control.check(iteration, residual_norm);
+
+        while (state == SolverControl::iterate)
+        {
+            hessenberg = 0.0;
+            std::fill(rhs.begin(), rhs.end(), 0.0);
+            rhs[0] = residual_norm;
+            basis[0] /= residual_norm;
+
+            unsigned int dimension = 0;
+            for (unsigned int j = 0; j < restart && state == SolverControl::iterate; ++j)
+            {
+                preconditioner.vmult(preconditioned_basis[j], basis[j]);
+                A.vmult(basis[j + 1], preconditioned_basis[j]);
+
+                const double norm = orthogonalize(j + 1, basis[j + 1], coefficients);
+                n_mgs_reductions += j + 2;
+
+                for (unsigned int i = 0; i <= j; ++i)
+                    hessenberg(i, j) = coefficients[i];
+                hessenberg(j + 1, j) = norm;
+
+                if (norm > 0.0)
+                    basis[j + 1] /= norm;
+
+                // Reduce the new column of the Hessenberg matrix to upper
+                // triangular form with the previous rotations and a new one
+                for (unsigned int i = 0; i < j; ++i)
+                {
+                    const double h_i = hessenberg(i, j);
+                    hessenberg(i, j) = givens_cos[i] * h_i + givens_sin[i] * hessenberg(i + 1, j);
+                    hessenberg(i + 1, j) = -givens_sin[i] * h_i + givens_cos[i] * hessenberg(i + 1, j);
+                }
+
+                const double r = std::hypot(hessenberg(j, j), hessenberg(j + 1, j));
+                givens_cos[j] = hessenberg(j, j) / r;
+                givens_sin[j] = hessenberg(j + 1, j) / r;
+                hessenberg(j, j) = r;
+                hessenberg(j + 1, j) = 0.0;
+
+                rhs[j + 1] = -givens_sin[j] * rhs[j];
+                rhs[j] *= givens_cos[j];
+
+                residual_norm = std::abs(rhs[j + 1]);
+                dimension = j + 1;
+
+                state = solver_control.check(++iteration, residual_norm);
+
+                // Lucky breakdown: the Krylov space contains the solution
+                if (norm == 0.0)
+                    break;
+            }
+
+            // x += Z y, with H y = g on the triangularized Hessenberg matrix
+            for (unsigned int i = dimension; i-- > 0;)
+            {
+                double sum = rhs[i];
+                for (unsigned int k = i + 1; k < dimension; ++k)
+                    sum -= hessenberg(i, k) * coefficients[k];
+                coefficients[i] = sum / hessenberg(i, i);
+            }
+            for (unsigned int i = 0; i < dimension; ++i)
+                x.add(coefficients[i], preconditioned_basis[i]);
+
+            if (state != SolverControl::iterate)
+                break;
+
+            // Restart from the true residual
+            A.vmult(basis[0], x);
+            basis[0].sadd(-1.0, 1.0, b);
+            residual_norm = basis[0].l2_norm();
+            ++n_fused_reductions;
+            ++n_mgs_reductions;
+        }
+
+        AssertThrow(state == SolverControl::success,
+                    SolverControl::NoConvergence(solver_control.last_step(),
+                                                 solver_control.last_value()));
+    }
+
+    // Global reductions of the last solve.
+    unsigned int n_reductions() const
+    {
+        return n_fused_reductions;
+    }
+
+    // Global reductions modified Gram-Schmidt would have needed for the same iterations.
+    unsigned int n_reductions_mgs() const
+    {
+        return n_mgs_reductions;
+    }
+
+private:
+    // Orthogonalize w against basis[0, n) with two classical Gram-Schmidt
+    // passes, store the projections in coefficients and return ||w||.
+    double orthogonalize(const unsigned int n,
+                         TrilinosWrappers::MPI::BlockVector &w,
+                         std::vector<double> &coefficients)
+    {
+        std::vector<double> local(n + 1), global(n + 1);
+
+        // First pass: c = V^T w
+        for (unsigned int i = 0; i < n; ++i)
+            local[i] = local_dot(basis[i], w);
+        fused_sum(local, global, n);
+
+        for (unsigned int i = 0; i < n; ++i)
+        {
+            coefficients[i] = global[i];
+            w.add(-global[i], basis[i]);
+        }
+
+        // Second pass: c' = V^T w, together with ||w||^2
+        for (unsigned int i = 0; i < n; ++i)
+            local[i] = local_dot(basis[i], w);
+        local[n] = local_dot(w, w);
+        fused_sum(local, global, n + 1);
+
+        double norm_squared = global[n];
+        for (unsigned int i = 0; i < n; ++i)
+        {
+            coefficients[i] += global[i];
+            w.add(-global[i], basis[i]);
+            norm_squared -= global[i] * global[i];
+        }
+
+        // The update by Pythagoras' theorem is inaccurate when w is almost
+        // in the span of the basis: compute the norm explicitly then.
+        if (norm_squared <= 1e-4 * global[n])
+        {
+            ++n_fused_reductions;
+            return w.l2_norm();
+        }
+
+        return std::sqrt(norm_squared);
+    }
+
+    // Sum the first n entries of local over the processes, in one reduction.
+    void fused_sum(const std::vector<double> &local, std::vector<double> &global, const unsigned int n)
+    {
+        MPI_Allreduce(local.data(), global.data(), n, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+        ++n_fused_reductions;
+    }
+
+    // Dot product of the locally owned entries.
+    static double local_dot(const TrilinosWrappers::MPI::BlockVector &u,
+                            const TrilinosWrappers::MPI::BlockVector &v)
+    {
+        double sum = 0.0;
+        for (unsigned int b = 0; b < u.n_blocks(); ++b)
+        {
+            const double *u_values = u.block(b).begin();
+            const double *v_values = v.block(b).begin();
+            const std::size_t n = u.block(b).end() - u.block(b).begin();
+            for (std::size_t k = 0; k < n; ++k)
+                sum += u_values[k] * v_values[k];
+        }
+        return sum;
+    }
+
+    SolverControl &solver_control;                              // Stopping criterion
+
+    const unsigned int restart;                                 // Krylov vectors before a restart
+
+    std::vector<TrilinosWrappers::MPI::BlockVector> basis;      // Orthonormal Arnoldi basis V
+
+    std::vector<TrilinosWrappers::MPI::BlockVector> preconditioned_basis; // Z = P^{-1} V
+
+    unsigned int n_fused_reductions = 0;                        // Reductions of the last solve
+
+    unsigned int n_mgs_reductions = 0;                          // Reductions of the same solve with modified Gram-Schmidt
+};
+
+#endif
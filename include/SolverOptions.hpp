@@ -0,0 +1,60 @@
+#ifndef SOLVER_OPTIONS_HPP
+#define SOLVER_OPTIONS_HPP
+
+#include <string>
+#include <vector>
+
+// ---------------------------------------------------------------
+// Struct: SolverOptions
+//
+// Description:
+//   Optional run-time settings shared by the solvers. Every field
+//   has a default, so a parameters file that only contains the
+//   required variables reproduces the original behaviour.
+// ---------------------------------------------------------------
+struct SolverOptions
+{
+    std::string probes_file = "";                               // Probe definition file (empty = no probes)
+
+    unsigned int bdf_order = 1;                                 // Time scheme of the monolithic solver (1 or 2)
+
+    unsigned int extrapolation_depth = 0;                       // Past solutions extrapolated for the Krylov initial guess (0 = off)
+
+    unsigned int projection_depth = 0;                          // Past solutions spanning the initial guess projection (0 = off)
+
+    double inner_tolerance = 1e-2;                              // Relative tolerance of the inner solves of the block preconditioners
+
+    unsigned int inner_cycles = 0;                              // Fixed inner preconditioner cycles instead of inner solves (0 = off)
+
+    bool mixed_precision = false;                               // Single-precision ILU(0) inner preconditioners
+
+    bool velocity_multigrid = false;                            // p-multigrid (P2 smoothing, P1 coarse level) for the velocity block
+
+    std::string preconditioner = "simple";                      // Block preconditioner of the monolithic solver
+
+    std::string gmres_orthogonalization = "mgs";                // Orthogonalization of the outer GMRES: mgs or cgs2 (fused reductions)
+
+    std::string direct_solver = "none";                         // Sparse LU instead of the Krylov solvers: none, klu, umfpack, mumps or superludist
+
+    double grad_div = 0.0;                                      // Grad-div stabilization coefficient gamma (0 = off)
+
+    bool stabilization = false;                                 // SUPG/PSPG stabilization (allows equal-order elements)
+
+    bool geometry_cache = true;                                 // Store the geometry of every cell (false = recompute it from the vertices)
+
+    std::vector<double> reynolds_sweep = {};                    // Reynolds numbers of a steady continuation sweep (empty = single Re)
+
+    unsigned int newton_max_iterations = 20;                    // Maximum nonlinear iterations of the steady solver
+
+    double newton_tolerance = 1e-8;                             // Reduction of the nonlinear residual norm that stops the steady solver
+
+    unsigned int picard_iterations = 0;                         // Picard iterations before switching to Newton (0 = Newton only)
+
+    unsigned int line_search_steps = 10;                        // Maximum step halvings of the backtracking line search (0 = full steps)
+
+    std::string nonlinear_solver = "newton";                    // Nonlinear iterations of the steady solver: newton or anderson
+
+    unsigned int anderson_depth = 5;                            // Past iterates mixed by Anderson acceleration (0 = plain Picard)
+};
+
+#endif
@@ -0,0 +1,124 @@
+#ifndef SPARSE_DIRECT_SOLVER_HPP
+#define SPARSE_DIRECT_SOLVER_HPP
+
+#include "includes_file.hpp"
+
+#include <Amesos.h>
+#include <Amesos_BaseSolver.h>
+#include <Epetra_LinearProblem.h>
+
+using namespace dealii;
+
+// ---------------------------------------------------------------
+// Class: SparseDirectSolver
+//
+// Description:
+//   Sparse LU factorization of a Trilinos matrix through Amesos (KLU,
+//   UMFPACK, MUMPS or SuperLU_DIST, depending on how Trilinos was
+//   built), split into its three phases:
+//
+//     - symbolic analysis (fill-reducing ordering and pattern of the
+//       factors), which only depends on the sparsity pattern;
+//     - numeric factorization, which depends on the values;
+//     - triangular solves, one per right-hand side.
+//
+//   TrilinosWrappers::SolverDirect runs the first two at every
+//   initialize(). Here the analysis is kept as long as factorize() is
+//   called with the same matrix object, whose pattern does not change
+//   after setup in the solvers: a matrix reassembled at every step only
+//   pays the numeric factorization, and a constant matrix is factorized
+//   once and then only costs triangular solves.
+// ---------------------------------------------------------------
+class SparseDirectSolver
+{
+public:
+    // Select the factorization package (klu, umfpack, mumps or
+    // superludist). Must be called before factorize(); resets the analysis.
+    void set_solver(const std::string &solver_name_)
+    {
+        static const std::map<std::string, std::string> amesos_names = {
+            {"klu", "Amesos_Klu"}, {"umfpack", "Amesos_Umfpack"}, {"mumps", "Amesos_Mumps"}, {"superludist", "Amesos_Superludist"}};
+        AssertThrow(amesos_names.count(solver_name_) > 0,
+                    ExcMessage("Unknown direct solver '" + solver_name_ + "'"));
+
+        Amesos factory;
+        AssertThrow(factory.Query(amesos_names.at(solver_name_)),
+                    ExcMessage("Direct solver '" + solver_name_ + "' is not available in this Trilinos installation."));
+
+        solver_name = amesos_names.at(solver_name_);
+        solver.reset();
+        factorized_matrix = nullptr;
+    }
+
+    // Compute the numeric factorization of matrix, preceded by the
+    // symbolic analysis if matrix is not the one of the previous call.
+    void factorize(const TrilinosWrappers::SparseMatrix &matrix)
+    {
+        AssertThrow(!solver_name.empty(), ExcMessage("SparseDirectSolver::factorize() called before set_solver()."));
+
+        const Epetra_CrsMatrix *epetra_matrix = &matrix.trilinos_matrix();
+
+        if (epetra_matrix != factorized_matrix || !solver)
+        {
+            problem.SetOperator(const_cast<Epetra_CrsMatrix *>(epetra_matrix));
+
+            Amesos factory;
+            solver.reset(factory.Create(solver_name.c_str(), problem));
+            AssertThrow(solver, ExcMessage("Cannot create the direct solver " + solver_name));
+
+            const int ierr = solver->SymbolicFactorization();
+            AssertThrow(ierr == 0, ExcMessage("Symbolic factorization failed with error " + std::to_string(ierr)));
+
+            factorized_matrix = epetra_matrix;
+            ++n_symbolic;
+        }
+
+        const int ierr = solver->NumericFactorization();
+        AssertThrow(ierr == 0, ExcMessage("Numeric factorization failed with error " + std::to_string(ierr)));
+        ++n_numeric;
+    }
+
+    // Solve matrix * dst = src with the current factorization.
+    void solve(TrilinosWrappers::MPI::Vector &dst, const TrilinosWrappers::MPI::Vector &src)
+    {
+        AssertThrow(solver, ExcMessage("SparseDirectSolver::solve() called before factorize()."));
+
+        problem.SetLHS(&dst.trilinos_vector());
+        problem.SetRHS(const_cast<Epetra_FEVector *>(&src.trilinos_vector()));
+
+        const int ierr = solver->Solve();
+        AssertThrow(ierr == 0, ExcMessage("Direct solve failed with error " + std::to_string(ierr)));
+    }
+
+    // True once a factorization is available.
+    bool factorized() const
+    {
+        return factorized_matrix != nullptr;
+    }
+
+    // Symbolic analyses and numeric factorizations computed so far.
+    unsigned int n_symbolic_factorizations() const
+    {
+        return n_symbolic;
+    }
+
+    unsigned int n_numeric_factorizations() const
+    {
+        return n_numeric;
+    }
+
+private:
+    std::string solver_name;                                    // Amesos class of the factorization package
+
+    Epetra_LinearProblem problem;                               // Matrix and vectors seen by the solver
+
+    std::unique_ptr<Amesos_BaseSolver> solver;                  // Factorization (null before the first factorize())
+
+    const Epetra_CrsMatrix *factorized_matrix = nullptr;        // Matrix whose analysis is stored
+
+    unsigned int n_symbolic = 0;                                // Symbolic analyses computed
+
+    unsigned int n_numeric = 0;                                 // Numeric factorizations computed
+};
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef STABILIZATION_HPP
+#define STABILIZATION_HPP
+
+#include <cmath>
+
+// ---------------------------------------------------------------
+// Function: compute_stabilization_parameter
+//
+// Description:
+//   Stabilization parameter of the SUPG/PSPG terms, in the usual
+//   form that blends the transient, convective and viscous limits:
+//
+//       tau = ( (2 sigma)^2 + (2 |a| / h)^2 + (4 nu / h^2)^2 )^{-1/2},
+//
+//   where sigma is the coefficient of the time derivative (alpha_0/dt,
+//   0 for steady problems), a the advection velocity and h the
+//   element size (divided by the velocity degree for higher-order
+//   elements).
+//
+//   The stabilized formulations use the strong residual of the
+//   momentum equation without its viscous part. For linear elements
+//   (the equal-order P1-P1 pair) this part vanishes inside each cell,
+//   so the stabilization is consistent.
+// ---------------------------------------------------------------
+inline double compute_stabilization_parameter(const double &h,
+                                              const double &velocity_norm,
+                                              const double &nu,
+                                              const double &sigma)
+{
+    const double transient = 2.0 * sigma;
+    const double convective = 2.0 * velocity_norm / h;
+    const double viscous = 4.0 * nu / (h * h);
+
+    return 1.0 / std::sqrt(transient * transient + convective * convective + viscous * viscous);
+}
+
+#endif
@@ -2,9 +2,15 @@
 #define STEADYNAVIERSTOKES_HPP
 
 #include "includes_file.hpp"
+#include "Probes.hpp"
+#include "SolverOptions.hpp"
+#include "GeometryCache.hpp"
+#include "ReferenceShapes.hpp"
 
 using namespace dealii;
 
+class PreconditionAugmentedLagrangian;
+
 // ==================================================================
 // Base Class: SteadyNavierStokes
 //
@@ -169,14 +175,16 @@ public:
 	//   degree_velocity_in - polynomial degree for velocity.
 	//   degree_pressure_in - polynomial degree for pressure.
 	//   Re_in - Reynolds number.
+	//   options_in - optional run-time settings.
 	// ............................................................
 
 	SteadyNavierStokes(
 		const std::string &mesh_file_name_in,
 		const unsigned int degree_velocity_in,
 		const unsigned int degree_pressure_in,
-		const double Re_in)
-		: mesh_file_name(mesh_file_name_in), degree_velocity(degree_velocity_in), degree_pressure(degree_pressure_in), Re(Re_in), H(0.41), D(0.1), uMax(dim == 2 ? 0.3 : 0.45), uMean(dim == 2 ? 2. / 3. * uMax : 4. / 9. * uMax), nu(uMean * D / Re), p_out(0.0), forcing_term(), inlet_velocity(H, uMax), mpi_size(Utilities::MPI::n_mpi_processes(MPI_COMM_WORLD)), mpi_rank(Utilities::MPI::this_mpi_process(MPI_COMM_WORLD)), pcout(std::cout, mpi_rank == 0), mesh(MPI_COMM_WORLD), dof_handler(mesh)
+		const double Re_in,
+		const SolverOptions &options_in = SolverOptions())
+		: mesh_file_name(mesh_file_name_in), degree_velocity(degree_velocity_in), degree_pressure(degree_pressure_in), Re(Re_in), options(options_in), H(0.41), D(0.1), uMax(dim == 2 ? 0.3 : 0.45), uMean(dim == 2 ? 2. / 3. * uMax : 4. / 9. * uMax), nu(uMean * D / Re), p_out(0.0), forcing_term(), inlet_velocity(H, uMax), mpi_size(Utilities::MPI::n_mpi_processes(MPI_COMM_WORLD)), mpi_rank(Utilities::MPI::this_mpi_process(MPI_COMM_WORLD)), pcout(std::cout, mpi_rank == 0), mesh(MPI_COMM_WORLD), dof_handler(mesh)
 		{}
 
 	// Disallow copy construction for clarity.
@@ -185,6 +193,11 @@ public:
 
 	auto run_full_problem_pipeline() -> void; // Instantiates and runs the full problem pipeline and computes lift/drag.
 
+	auto run_reynolds_sweep() -> void; // Runs the pipeline for every Re of options.reynolds_sweep, with a single setup and warm starts.
+
+	auto set_reynolds_number(const double Re_in) -> void // changes the Reynolds number and the viscosity, keeping mesh and DoFs
+	{Re = Re_in; nu = uMean * D / Re;}
+
 	auto get_mesh_file_name() const -> const std::string& // returns the mesh file name
 	{return mesh_file_name;}
 
@@ -206,6 +219,15 @@ public:
 	auto get_Re() const -> double // returns the Reynolds number
 	{return Re;}
 
+	auto get_drag() const -> double // returns the drag coefficient of the last compute_lift_drag()
+	{return drag;}
+
+	auto get_lift() const -> double // returns the lift coefficient of the last compute_lift_drag()
+	{return lift;}
+
+	auto get_options() const -> const SolverOptions& // returns the optional run-time settings
+	{return options;}
+
 	// Provide access to the mesh
 	const parallel::fullydistributed::Triangulation<dim> &get_mesh() const
 	{
@@ -236,7 +258,8 @@ protected:
 	std::string mesh_file_name;  							// Mesh file name
 	const unsigned int degree_velocity;  					// Velocity polynomial degree
 	const unsigned int degree_pressure;  					// Pressure polynomial degree
-	const double Re;  										// Reynolds number
+	double Re;  											// Reynolds number (changed by a Reynolds sweep)
+	const SolverOptions options;  							// Optional run-time settings
 
 	// ================================
 	// Geometrical & Physical Values
@@ -245,7 +268,7 @@ protected:
 	const double D;      									// Diameter of the obstacle
 	const double uMax;   									// Maximum inflow velocity
 	const double uMean;  									// Mean inflow velocity
-	const double nu;     									// Viscosity
+	double nu;     											// Viscosity
 	const double p_out;  									// Outlet Neumann BC value
 
 	// ================================
@@ -280,6 +303,8 @@ protected:
 	std::vector<IndexSet> block_owned_dofs;  				// Block-wise owned DoFs
 	IndexSet locally_relevant_dofs;  						// Locally relevant DoFs
 	std::vector<IndexSet> block_relevant_dofs;  			// Block-wise relevant DoFs
+	ReferenceShapes<dim> shapes;  							// Shape functions at the reference quadrature points (Stokes and Newton assemblies)
+	GeometryCache<dim> geometry_cache;  					// Owned cells with their DoFs and geometry (Stokes and Newton assemblies)
 
 	// ================================
 	// Matrices & Vectors
@@ -319,23 +344,23 @@ public:
 	//   degree_velocity_in - polynomial degree for velocity.
 	//   degree_pressure_in - polynomial degree for pressure.
 	//   Re_in - Reynolds number.
+	//   options_in - optional run-time settings.
 	// ............................................................
 	
 	Stokes(const std::string &mesh_file_name_in,
 		   unsigned int degree_velocity_in,
 		   unsigned int degree_pressure_in,
-		   double Re_in)
+		   double Re_in,
+		   const SolverOptions &options_in = SolverOptions())
 		: SteadyNavierStokes<dim>(mesh_file_name_in,
 								  degree_velocity_in,
 								  degree_pressure_in,
-								  Re_in)
+								  Re_in,
+								  options_in)
 	{
 	}
 
-	auto get_solution() const -> TrilinosWrappers::MPI::BlockVector
-	{return this->solution;};
-
-	auto setup() -> void override; // Setup the problem by initializing the mesh, DoF handler, and finite element spaces.
+	auto setup() -> void override; // Setup the problem by initializing the mesh, DoF handler, constraints, sparsity patterns and vectors.
 
 	auto assemble() -> void override; // Assemble the system matrix and right-hand side.
 
@@ -344,6 +369,12 @@ public:
 	auto output() -> void override; // Save the output of the computation in a pvtk format.
 
 	auto get_output_directory() const -> std::string override; // Defines the path of the directory where the outputs will be stored
+
+protected:
+	// ================================
+	// Constraints
+
+	AffineConstraints<double> constraints;  			// Dirichlet constraints, shared with the Newton iterations
 	
 };
 
@@ -352,11 +383,15 @@ public:
 //
 // Description:
 //   This class solves the non-linear correction problem by
-//   taking into account the convective term.
+//   taking into account the convective term. It derives from Stokes,
+//   whose solution is the initial guess of the Newton iterations: both
+//   stages share the mesh, the DoF handler, the constraints, the
+//   sparsity patterns, the matrices and the vectors, which are set up
+//   once by setup().
 // ==================================================================
 
 template <int dim>
-class NonLinearCorrection : public SteadyNavierStokes<dim>
+class NonLinearCorrection : public Stokes<dim>
 {
 public:
 	// ============================== PUBLIC FUNCTIONS ===============================
@@ -365,19 +400,25 @@ public:
 	// Constructor
 	// ............................................................
 	// Parameters:
-	//   stokes_obj - Stokes object to copy the mesh and parameters.
+	//   mesh_file_name_in - name of the mesh file.
+	//   degree_velocity_in - polynomial degree for velocity.
+	//   degree_pressure_in - polynomial degree for pressure.
+	//   Re_in - Reynolds number.
+	//   options_in - optional run-time settings.
 	// ............................................................
 	
-	NonLinearCorrection(const Stokes<dim> &stokes_obj)
-		: SteadyNavierStokes<dim>(stokes_obj.get_mesh_file_name(),
-								  stokes_obj.get_degree_velocity(),
-								  stokes_obj.get_degree_pressure(),
-								  stokes_obj.get_Re()),
+	NonLinearCorrection(const std::string &mesh_file_name_in,
+						unsigned int degree_velocity_in,
+						unsigned int degree_pressure_in,
+						double Re_in,
+						const SolverOptions &options_in = SolverOptions())
+		: Stokes<dim>(mesh_file_name_in,
+					  degree_velocity_in,
+					  degree_pressure_in,
+					  Re_in,
+					  options_in),
 		  u_k(0), p_k(dim)
 	{
-		// Copy the fully-distributed Triangulation
-		this->mesh.copy_triangulation(stokes_obj.get_mesh());
-
 		// Compute scaling_factor for lift and drag computation, based on dimension
 		/*
 		 *  Scaling factor for flow past cylinder test case
@@ -411,34 +452,45 @@ public:
 
 	auto get_output_directory() const -> std::string override; // Defines the path of the directory where the outputs will be stored
 
-	// Set the initial conditions for the iterative scheme
-	auto set_initial_conditions(const TrilinosWrappers::MPI::BlockVector solution_stokes_) -> void
-	{
-		solution_old.reinit(solution_stokes_);
-		solution_old = solution_stokes_;
-	}
+	auto solve_stokes(const bool write_output = true) -> void; // Solve the Stokes problem on the shared system and move its solution into the initial guess
 
 	auto compute_lift_drag() -> void; // Compute lift and drag coefficients
 
+	auto get_newton_iterations() const -> unsigned int // returns the nonlinear iterations of the last solve()
+	{return iter;}
+
+	auto sample_probes() -> void; // Evaluate the solution at the probes listed in the probes file
+
 protected:
 	// ================================ PROTECTED FUNCTIONS ===============================
 
+	auto solve_linear_system() -> void; // Solve the linearized system for the next iterate, stored in solution_owned.
+
+	template <typename PreconditionerType>
+	auto solve_linear_system_cgs2(SolverControl &solver_control, const PreconditionerType &preconditioner) -> void; // Same, with the CGS2 flexible GMRES.
+
+	auto compute_residual_norm(const TrilinosWrappers::MPI::BlockVector &iterate) -> double; // Linearize at iterate and return the norm of the nonlinear residual.
+
+	auto solve_anderson() -> void; // Anderson-accelerated Picard iterations, used by solve() with nonlinear_solver = anderson.
+
 	// ================================
 	// Newton Iteration Parameters
-	unsigned int iter = 0;  							// Newton iterations counter
-	static constexpr unsigned int maxIter = 20;  		// Maximum iterations
-	static constexpr double tolerance = 1e-7;  			// Update tolerance
+	unsigned int iter = 0;  							// Nonlinear iterations counter
+	bool picard = false;  								// Picard linearization in assemble() (Newton otherwise)
+	static constexpr double sufficient_decrease = 1e-4;	// Armijo constant of the line search
 
 	// ================================
-	// Extractors and Constraints
+	// Extractors
 	FEValuesExtractors::Vector u_k;  					// Velocity extractor
 	FEValuesExtractors::Scalar p_k;  					// Pressure extractor
-	AffineConstraints<double> constraints;  			// Constraints
 
 	// ================================
 	// Iterative Scheme Data
-	TrilinosWrappers::MPI::BlockVector solution_old;  	// Old solution
-	TrilinosWrappers::MPI::BlockVector new_res;  		// Residual at current iteration
+	TrilinosWrappers::MPI::BlockVector solution_old;  	// Current iterate, linearization point of assemble() (ghosted)
+	TrilinosWrappers::MPI::BlockVector current_iterate;	// Current iterate (owned)
+	TrilinosWrappers::MPI::BlockVector newton_update;  	// Full step from the current iterate (Anderson: fixed-point residual)
+	TrilinosWrappers::MPI::BlockVector residual;  		// Nonlinear residual A(u) u - b(u)
+	std::shared_ptr<PreconditionAugmentedLagrangian> al_preconditioner; // Kept across linear solves and Reynolds numbers
 
 	// ================================
 	// Post-Processing Data
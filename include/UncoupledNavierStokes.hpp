@@ -2,6 +2,11 @@
 #define UNCOUPLED_NAVIER_STOKES_HPP
 
 #include "includes_file.hpp"
+#include "Probes.hpp"
+#include "SolverOptions.hpp"
+#include "SolutionHistory.hpp"
+#include "CellPairTable.hpp"
+#include "SparseDirectSolver.hpp"
 
 using namespace dealii;
 
@@ -90,6 +95,7 @@ public:
     //   T_ - final time.
     //   deltat_ - time step size.
     //   reynolds_number_ - Reynolds number.
+    //   options_ - optional run-time settings.
     // ............................................................
 
 UncoupledNavierStokes(
@@ -98,7 +104,8 @@ UncoupledNavierStokes(
         const unsigned int &degree_pressure_,
         const double &T_,
         const double &deltat_,
-        const double &reynolds_number_)
+        const double &reynolds_number_,
+        const SolverOptions &options_ = SolverOptions())
         : reynolds_number(reynolds_number_),
         T(T_),
         deltat(deltat_),
@@ -108,16 +115,19 @@ UncoupledNavierStokes(
         mesh(MPI_COMM_WORLD),
         mesh_file_name(mesh_file_name_),
         triangulation(),
-        fe_velocity(FE_SimplexP<dim>(2), dim),
+        fe_velocity(FE_SimplexP<dim>(degree_velocity_), dim),
         dof_handler_velocity(triangulation),
-        fe_pressure(1),
+        fe_pressure(degree_pressure_),
         dof_handler_pressure(triangulation),
         degree_velocity(degree_velocity_),
         degree_pressure(degree_pressure_),
         inlet_velocity(H),
+        options(options_),
         computing_timer(MPI_COMM_WORLD, pcout,
                         TimerOutput::summary,
-                        TimerOutput::wall_times)
+                        TimerOutput::wall_times),
+        velocity_history(options_.extrapolation_depth, options_.projection_depth),
+        pressure_history(options_.extrapolation_depth, options_.projection_depth)
     {
         this->nu = (2. / 3.) * inlet_velocity.get_u_max() * cylinder_radius / reynolds_number;
     }
@@ -129,15 +139,17 @@ private:
 
     auto setup() -> void; // Setup the problem by initializing the mesh, DoF handler, and finite element spaces.
 
+    auto assemble_constant_matrices() -> void; // Assemble once the time-independent matrices: pressure Laplacian, velocity and pressure mass.
+
     auto assemble_system_velocity() -> void; // Assemble the system matrix and right-hand side for the velocity problem.
 
     auto solve_velocity_system() -> void; // Solve the velocity system.
 
-    auto assemble_system_pressure() -> void; // Assemble the system matrix and right-hand side for the pressure problem.
+    auto assemble_projection_rhs() -> void; // Assemble in a single pass the right-hand sides that depend on the intermediate velocity only.
 
     auto solve_pressure_system() -> void; // Solve the pressure system.
 
-    auto update_velocity() -> void; // Assemble the system matrix and right-hand side for the velocity update problem.
+    auto update_velocity() -> void; // Add the pressure increment term to the right-hand side of the velocity update problem.
 
     auto solve_update_velocity_system() -> void; // Solve the velocity update system.
 
@@ -183,15 +195,30 @@ private:
     const std::string mesh_file_name;                           // Name of the mesh file
     Triangulation<dim> triangulation;                           // Main triangulation object for the domain
 
-    FESystem<dim> fe_velocity;                                  // Velocity finite element: Uses a Q2 (quadratic) vector-valued basis
+    FESystem<dim> fe_velocity;                                  // Velocity finite element: vector-valued P_k basis (k = degree_velocity)
     DoFHandler<dim> dof_handler_velocity;                       // DoF handler for velocity field
 
-    FE_SimplexP<dim> fe_pressure;                               // Pressure finite element: Uses a Q1 (linear) scalar-valued basis
+    FE_SimplexP<dim> fe_pressure;                               // Pressure finite element: scalar P_k basis (k = degree_pressure)
     DoFHandler<dim> dof_handler_pressure;                       // DoF handler for pressure field
 
     const unsigned int degree_velocity;                         // Polynomial degree for velocity field
     const unsigned int degree_pressure;                         // Polynomial degree for pressure field
 
+    // ================================
+    // Cell Data (built once in setup)
+
+    CellPairTable<dim> owned_cells;                             // Owned cells with the DoFs of both fields and their geometry
+    Quadrature<dim> velocity_quadrature;                        // Quadrature of the velocity problems
+    Quadrature<dim> pressure_quadrature;                        // Quadrature of the pressure problems
+    ReferenceShapes<dim> velocity_on_velocity_quadrature;       // Velocity shape functions at the velocity quadrature points
+    ReferenceShapes<dim> pressure_on_velocity_quadrature;       // Pressure shape functions at the velocity quadrature points
+    ReferenceShapes<dim> velocity_on_pressure_quadrature;       // Velocity shape functions at the pressure quadrature points
+    ReferenceShapes<dim> pressure_on_pressure_quadrature;       // Pressure shape functions at the pressure quadrature points
+    FullMatrix<double> reference_velocity_mass;                 // Velocity mass matrix of the reference cell
+
+    std::vector<std::pair<const typename CellPairTable<dim>::CellData *, unsigned int>>
+        cylinder_faces;                                         // Owned cells with a face on the cylinder, and the face
+
     // ================================
     // Boundary and Initial Conditions
 
@@ -203,6 +230,11 @@ private:
     // Note that forcing_term and neumann_function are not applied in this case 
     // To see an example of implementation please check the Numerical-Test Branch
 
+    // ================================
+    // Optional Settings
+
+    const SolverOptions options;                                // Optional run-time settings
+
     // ================================
     // Timing and Computational Monitoring
 
@@ -225,6 +257,20 @@ private:
     TrilinosWrappers::SparseMatrix velocity_matrix;             // System matrix for velocity field
     TrilinosWrappers::SparseMatrix pressure_matrix;             // System matrix for pressure field
     TrilinosWrappers::SparseMatrix velocity_update_matrix;      // Matrix used for velocity updates
+    TrilinosWrappers::SparseMatrix pressure_mass_matrix;        // Pressure mass matrix (rotational correction only)
+
+    TrilinosWrappers::PreconditionIC pressure_preconditioner;                // Preconditioner of the pressure system
+    TrilinosWrappers::PreconditionJacobi velocity_update_preconditioner;     // Preconditioner of the velocity update system
+    TrilinosWrappers::PreconditionIC pressure_mass_preconditioner;           // Preconditioner of the pressure mass matrix
+
+    // Sparse LU factorizations, used instead of the Krylov solvers when the
+    // option direct_solver is set. The last three matrices are constant and
+    // factorized once; the velocity matrix is refactorized at every step
+    // with the symbolic analysis of the first one.
+    SparseDirectSolver velocity_direct_solver;                  // Factorization of the velocity system
+    SparseDirectSolver pressure_direct_solver;                  // Factorization of the pressure Laplacian
+    SparseDirectSolver velocity_update_direct_solver;           // Factorization of the velocity mass matrix
+    SparseDirectSolver pressure_mass_direct_solver;             // Factorization of the pressure mass matrix
 
     // ================================
     // System Vectors
@@ -242,6 +288,10 @@ private:
     TrilinosWrappers::MPI::Vector deltap;                       // Change in pressure between iterations
     TrilinosWrappers::MPI::Vector pressure_solution;            // Solution vector for pressure field
     TrilinosWrappers::MPI::Vector pressure_system_rhs;          // Right-hand side of the pressure system
+    TrilinosWrappers::MPI::Vector divergence_rhs;               // ∫ div(u~) ψ_i dx, shared by the pressure system and the rotational correction
+
+    SolutionHistory<TrilinosWrappers::MPI::Vector> velocity_history; // Past intermediate velocities (initial guess of the velocity solve)
+    SolutionHistory<TrilinosWrappers::MPI::Vector> pressure_history; // Past pressure increments (initial guess of the pressure solve)
 
     // ================================
     // Post-Processing Data
@@ -256,6 +306,12 @@ private:
     double lift;                                                // Current lift force value
     double drag;                                                // Current drag force value
 
+    std::unique_ptr<Probes<dim>> probes;                        // Point probes (null if not requested)
+
+    double convection_assembly_time = 0.0;                      // Wall time spent in assemble_system_velocity() [s]
+
+    unsigned long n_convection_cells = 0;                       // Cells assembled by assemble_system_velocity()
+
 };
 
 #endif // UNCOUPLED_NAVIER_STOKES_HPP
@@ -2,6 +2,8 @@
 #define PRECONDITIONERS_HPP
 
 #include "includes_file.hpp"
+#include "PreconditionILUFloat.hpp"
+#include "PreconditionPMultigrid.hpp"
 
 // ---------------------------------------------------------------
 // Class: BlockPrecondition
@@ -9,6 +11,26 @@
 // Description:
 //   This class defines an abstract class for block preconditioners.
 //   It provides a virtual function to apply the preconditioner.
+//
+//   A preconditioner that runs inner Krylov solves to a tolerance is
+//   not a fixed linear operator: it changes at every application, so
+//   the outer solver must be a flexible one (FGMRES). Derived classes
+//   report this through is_variable().
+//
+//   Alternatively, each inner block inverse can be replaced by a fixed
+//   number of cycles of the inner preconditioner (AMG V-cycles or ILU
+//   sweeps, applied as a preconditioned Richardson iteration). The
+//   block preconditioner is then a fixed linear operator with a
+//   predictable cost per application.
+//
+//   In mixed precision the inner preconditioners are single-precision
+//   ILU(0) factorizations (see PreconditionILUFloat), while the block
+//   operations and the outer solver stay in double precision.
+//
+//   The velocity block of a P2 velocity can be preconditioned by a
+//   two-level p-multigrid cycle (see PreconditionPMultigrid) instead
+//   of AMG on the full P2 matrix: ILU smoothing on P2 and the inner
+//   preconditioner of the P1 Galerkin matrix as coarse solver.
 // ---------------------------------------------------------------
 
 class BlockPrecondition
@@ -18,12 +40,113 @@ public:
     virtual void vmult(TrilinosWrappers::MPI::BlockVector &dst,
                        const TrilinosWrappers::MPI::BlockVector &src) const = 0;
 
+    // True if the preconditioner changes between applications (inner iterative solves).
+    virtual bool is_variable() const
+    {
+        return n_inner_cycles == 0;
+    }
+
+    // Replace the inner solves by n_cycles_ cycles of the inner preconditioners
+    // (0 restores the inner Krylov solves). Must be called before initialize().
+    void set_inner_cycles(const unsigned int &n_cycles_)
+    {
+        n_inner_cycles = n_cycles_;
+    }
+
+    // Store and apply the inner preconditioners in single precision.
+    // Must be called before initialize().
+    void set_mixed_precision(const bool &mixed_precision_)
+    {
+        mixed_precision = mixed_precision_;
+    }
+
+    // Keep the AMG hierarchy of the velocity block between initialize()
+    // calls on the same matrix, whose pattern must not change: only its
+    // values are recomputed, with the aggregates of the first call.
+    // Must be called before initialize().
+    void set_hierarchy_reuse(const bool &reuse_hierarchy_)
+    {
+        reuse_hierarchy = reuse_hierarchy_;
+    }
+
+    // Declare that B and B^T are reassembled at every initialize(), as with
+    // the SUPG/PSPG stabilization: the matrices built from them once and
+    // then kept (Yosida's -S, the LSC matrix L) are recomputed at every
+    // call. Must be called before initialize().
+    void set_variable_coupling(const bool &variable_coupling_)
+    {
+        variable_coupling = variable_coupling_;
+    }
+
+    // Precondition the velocity block with p-multigrid, with the given
+    // prolongation from the P1 velocity space. Must be called before
+    // initialize(), and prolongation_ must outlive the preconditioner.
+    void set_velocity_multigrid(const TrilinosWrappers::SparseMatrix &prolongation_)
+    {
+        velocity_prolongation = &prolongation_;
+    }
+
 protected:
+    // Approximate dst = matrix^{-1} src, either with a GMRES solve to the
+    // relative tolerance tol or with a fixed number of preconditioned
+    // Richardson cycles:
+    //     dst_{k+1} = dst_k + P^{-1} (src - matrix * dst_k),  dst_0 = 0.
+    void solve_inner(const TrilinosWrappers::SparseMatrix &matrix,
+                     const TrilinosWrappers::PreconditionBase &preconditioner,
+                     TrilinosWrappers::MPI::Vector &dst,
+                     const TrilinosWrappers::MPI::Vector &src,
+                     const unsigned int &maxit,
+                     const double &tol) const
+    {
+        if (n_inner_cycles == 0)
+        {
+            SolverControl solver_control(maxit, tol * src.l2_norm());
+            SolverGMRES<TrilinosWrappers::MPI::Vector> solver(solver_control);
+            solver.solve(matrix, dst, src, preconditioner);
+            return;
+        }
+
+        preconditioner.vmult(dst, src);
+
+        if (n_inner_cycles > 1)
+        {
+            inner_residual.reinit(src, true);
+            inner_correction.reinit(dst, true);
+
+            for (unsigned int k = 1; k < n_inner_cycles; ++k)
+            {
+                matrix.vmult(inner_residual, dst);
+                inner_residual.sadd(-1.0, 1.0, src);
+                preconditioner.vmult(inner_correction, inner_residual);
+                dst += inner_correction;
+            }
+        }
+    }
+
     void initialize_inner_preconditioner(
         std::shared_ptr<TrilinosWrappers::PreconditionBase> &preconditioner,
         const TrilinosWrappers::SparseMatrix &matrix, bool use_ilu)
     {
-        if (use_ilu)
+        // Trilinos only builds double-precision ILU and AMG: in mixed
+        // precision both are replaced by the float ILU(0). Replacing AMG
+        // changes the method, not only the precision, so it is reported
+        // once.
+        if (mixed_precision)
+        {
+            if (!use_ilu && !amg_replacement_reported)
+            {
+                if (Utilities::MPI::this_mpi_process(matrix.get_mpi_communicator()) == 0)
+                    std::cout << "Warning: mixed_precision replaces the AMG inner preconditioners "
+                              << "by single-precision ILU(0)" << std::endl;
+                amg_replacement_reported = true;
+            }
+
+            std::shared_ptr<PreconditionILUFloat> actual_preconditioner =
+                std::make_shared<PreconditionILUFloat>();
+            actual_preconditioner->initialize(matrix);
+            preconditioner = actual_preconditioner;
+        }
+        else if (use_ilu)
         {
             std::shared_ptr<TrilinosWrappers::PreconditionILU> actual_preconditioner =
                 std::make_shared<TrilinosWrappers::PreconditionILU>();
@@ -38,6 +161,63 @@ protected:
             preconditioner = actual_preconditioner;
         }
     }
+
+    // Recompute an AMG preconditioner for the new values of the matrix it
+    // was built on, keeping its aggregates. Returns false, doing nothing, if
+    // preconditioner is not an AMG one.
+    bool refresh_inner_preconditioner(const std::shared_ptr<TrilinosWrappers::PreconditionBase> &preconditioner)
+    {
+        const std::shared_ptr<TrilinosWrappers::PreconditionAMG> amg =
+            std::dynamic_pointer_cast<TrilinosWrappers::PreconditionAMG>(preconditioner);
+        if (!amg)
+            return false;
+
+        amg->reinit();
+        return true;
+    }
+
+    // Same as initialize_inner_preconditioner, for the velocity block:
+    // with a prolongation set, a p-multigrid cycle whose smoother is the
+    // ILU of matrix and whose coarse solver is the inner preconditioner
+    // of the P1 Galerkin matrix.
+    void initialize_velocity_preconditioner(
+        std::shared_ptr<TrilinosWrappers::PreconditionBase> &preconditioner,
+        const TrilinosWrappers::SparseMatrix &matrix, bool use_ilu)
+    {
+        if (velocity_prolongation == nullptr)
+        {
+            initialize_inner_preconditioner(preconditioner, matrix, use_ilu);
+            return;
+        }
+
+        std::shared_ptr<PreconditionPMultigrid> multigrid = std::make_shared<PreconditionPMultigrid>();
+        multigrid->initialize(matrix, *velocity_prolongation);
+
+        std::shared_ptr<TrilinosWrappers::PreconditionBase> smoother, coarse_preconditioner;
+        initialize_inner_preconditioner(smoother, matrix, true);
+        initialize_inner_preconditioner(coarse_preconditioner, multigrid->get_coarse_matrix(), use_ilu);
+        multigrid->set_smoother(smoother);
+        multigrid->set_coarse_preconditioner(coarse_preconditioner);
+
+        preconditioner = multigrid;
+    }
+
+    unsigned int n_inner_cycles = 0;                            // Inner preconditioner cycles (0 = inner Krylov solves)
+
+    bool mixed_precision = false;                               // Single-precision inner preconditioners
+
+    const TrilinosWrappers::SparseMatrix *velocity_prolongation = nullptr; // P1 to velocity prolongation (nullptr = no p-multigrid)
+
+    bool reuse_hierarchy = false;                               // Refresh the velocity AMG of the same matrix instead of rebuilding it
+
+    bool variable_coupling = false;                             // B and B^T change between initialize() calls
+
+private:
+    bool amg_replacement_reported = false;                      // Mixed-precision AMG replacement already reported
+
+    mutable TrilinosWrappers::MPI::Vector inner_residual;       // Residual of the Richardson cycles
+
+    mutable TrilinosWrappers::MPI::Vector inner_correction;     // Correction of the Richardson cycles
 };
 
 // ---------------------------------------------------------------
@@ -105,7 +285,7 @@ public:
         // Initialize the inner preconditioners for both the C block and the Schur complement S.
         // These preconditioners (preconditioner_C for C and preconditioner_S for S) will be
         // used to solve the corresponding subsystems iteratively.
-        this->initialize_inner_preconditioner(preconditioner_C, *C_matrix, use_ilu);
+        this->initialize_velocity_preconditioner(preconditioner_C, *C_matrix, use_ilu);
         this->initialize_inner_preconditioner(preconditioner_S, S_matrix, use_ilu);
     }
 
@@ -137,10 +317,9 @@ public:
 
         // Step 1.1: Solve for the velocity-like component (u-part):
         //         C * sol1_u = src_u
-        // Here, we solve the linear system using GMRES with preconditioning.
-        SolverControl solver_control_C(maxit, tol * src.block(0).l2_norm());
-        SolverGMRES<TrilinosWrappers::MPI::Vector> solver_C(solver_control_C);
-        solver_C.solve(*C_matrix, tmp.block(0), src.block(0), *preconditioner_C);
+        // Here, we solve the linear system using GMRES with preconditioning
+        // (or a fixed number of preconditioner cycles).
+        this->solve_inner(*C_matrix, *preconditioner_C, tmp.block(0), src.block(0), maxit, tol);
 
         // Step 1.2: Solve for the pressure-like component (p-part):
         //         S * sol1_p = B * sol1_u - src_p
@@ -149,9 +328,7 @@ public:
         tmp.block(1) -= src.block(1);
 
         // Solve for sol1_p using GMRES with the corresponding preconditioner.
-        SolverControl solver_control_S(maxit, tol * tmp.block(1).l2_norm());
-        SolverGMRES<TrilinosWrappers::MPI::Vector> solver_S(solver_control_S);
-        solver_S.solve(S_matrix, dst.block(1), tmp.block(1), *preconditioner_S);
+        this->solve_inner(S_matrix, *preconditioner_S, dst.block(1), tmp.block(1), maxit, tol);
 
         // =====================================================
         // Step 2: Solve the correction system
@@ -272,7 +449,7 @@ public:
 
         // Set up inner iterative solvers for the C block and the approximate
         // Schur complement (negS_matrix), possibly using ILU if indicated.
-        this->initialize_inner_preconditioner(preconditioner_C, *C_matrix, use_ilu);
+        this->initialize_velocity_preconditioner(preconditioner_C, *C_matrix, use_ilu);
         this->initialize_inner_preconditioner(preconditioner_S, negS_matrix, use_ilu);
     }
 
@@ -311,9 +488,7 @@ public:
         // --- Step 1 ---
         // Solve for the primary (first block) variable.
         // This computes an approximate inverse of C applied to the first part of src.
-        SolverControl solver_control_C(maxit, tol * src.block(0).l2_norm());
-        SolverGMRES<TrilinosWrappers::MPI::Vector> solver_C(solver_control_C);
-        solver_C.solve(*C_matrix, dst.block(0), src.block(0), *preconditioner_C);
+        this->solve_inner(*C_matrix, *preconditioner_C, dst.block(0), src.block(0), maxit, tol);
 
         // --- Step 2 ---
         // Copy the secondary part of src into a temporary container.
@@ -325,9 +500,7 @@ public:
         // --- Step 3 ---
         // Solve the system with the approximate Schur complement.
         // This computes the secondary variable by inverting negS_matrix.
-        SolverControl solver_control_S(maxit, tol * tmp.block(1).l2_norm());
-        SolverGMRES<TrilinosWrappers::MPI::Vector> solver_S(solver_control_S);
-        solver_S.solve(negS_matrix, dst.block(1), tmp.block(1), *preconditioner_S);
+        this->solve_inner(negS_matrix, *preconditioner_S, dst.block(1), tmp.block(1), maxit, tol);
 
         // --- Step 4 ---
         // Scale the primary component by the original diagonal entries.
@@ -396,6 +569,16 @@ public:
         negB_matrix = &negB_matrix_;
         Bt_matrix = &Bt_matrix_;
 
+        // Initialize the preconditioner of C, which changes at every time step.
+        this->initialize_velocity_preconditioner(preconditioner_C, *C_matrix, use_ilu);
+
+        // -S only depends on B, B^T and the constant matrix M_dt: unless the
+        // coupling blocks are reassembled at every step (stabilization), it
+        // is built, together with its preconditioner, at the first call and
+        // reused afterwards.
+        if (negS_ready && !this->variable_coupling)
+            return;
+
         // Save the inverse diagonal of M_dt.
         Dinv_vector.reinit(vec.block(0));
         for (unsigned int index : Dinv_vector.locally_owned_elements())
@@ -406,9 +589,9 @@ public:
         // Create the matrix -S.
         negB_matrix->mmult(negS_matrix, *Bt_matrix, Dinv_vector);
 
-        // Initialize the preconditioners.
-        this->initialize_inner_preconditioner(preconditioner_C, *C_matrix, use_ilu);
         this->initialize_inner_preconditioner(preconditioner_S, negS_matrix, use_ilu);
+
+        negS_ready = true;
     }
 
     // Application of the preconditioner.
@@ -419,23 +602,17 @@ public:
         // Step 1: solve [C0; B -S]sol1 = src.
         // Step 1.1: solve C*sol1_u = src_u.
         tmp.block(0) = dst.block(0);
-        SolverControl solver_control_C(maxit, tol * src.block(0).l2_norm());
-        SolverGMRES<TrilinosWrappers::MPI::Vector> solver_C(solver_control_C);
-        solver_C.solve(*C_matrix, tmp.block(0), src.block(0), *preconditioner_C);
+        this->solve_inner(*C_matrix, *preconditioner_C, tmp.block(0), src.block(0), maxit, tol);
         // Step 1.2: solve -S*sol1_p = -B*sol1_u + src_p.
         tmp.block(1) = src.block(1);
         negB_matrix->vmult_add(tmp.block(1), tmp.block(0));
-        SolverControl solver_control_S(maxit, tol * tmp.block(1).l2_norm());
-        SolverGMRES<TrilinosWrappers::MPI::Vector> solver_S(solver_control_S);
-        solver_S.solve(negS_matrix, dst.block(1), tmp.block(1), *preconditioner_S);
+        this->solve_inner(negS_matrix, *preconditioner_S, dst.block(1), tmp.block(1), maxit, tol);
 
         // Step 2: solve [I C^-1*B^T; 0 I]dst = sol1.
         tmp_2 = src.block(0);
         dst.block(0) = tmp.block(0);
         Bt_matrix->vmult(tmp.block(0), dst.block(1));
-        SolverControl solver_control_C2(maxit, tol * tmp.block(0).l2_norm());
-        SolverGMRES<TrilinosWrappers::MPI::Vector> solver_gmres_C2(solver_control_C);
-        solver_gmres_C2.solve(*C_matrix, tmp_2, tmp.block(0), *preconditioner_C);
+        this->solve_inner(*C_matrix, *preconditioner_C, tmp_2, tmp.block(0), maxit, tol);
         dst.block(0) -= tmp_2;
     }
 
@@ -458,10 +635,424 @@ private:
 
     mutable TrilinosWrappers::MPI::Vector tmp_2;
 
+    bool negS_ready = false;
+
     unsigned int maxit;
 
     double tol;
 };
 
+// ---------------------------------------------------------------
+// Class: PreconditionBlockTriangular
+//
+// Description:
+//   Base class of the block upper triangular preconditioners
+//
+//       P = [ F   B^T ]
+//           [ 0   S   ]
+//
+//   where F is the (1,1)-block, B^T the (1,2)-block and S an
+//   approximation of the (positive) Schur complement -B F^{-1} B^T.
+//   With the exact Schur complement the preconditioned matrix has a
+//   single eigenvalue, so the quality of the preconditioner is that
+//   of the approximation of S^{-1}, provided by the derived classes
+//   through vmult_schur().
+// ---------------------------------------------------------------
+class PreconditionBlockTriangular : public BlockPrecondition
+{
+public:
+    // Apply the preconditioner:
+    //   1. dst_p = S^{-1} src_p
+    //   2. dst_u = F^{-1} (src_u - B^T dst_p)
+    void vmult(TrilinosWrappers::MPI::BlockVector &dst,
+               const TrilinosWrappers::MPI::BlockVector &src) const override
+    {
+        tmp.reinit(src);
+
+        vmult_schur(dst.block(1), src.block(1));
+
+        Bt_matrix->vmult(tmp.block(0), dst.block(1));
+        tmp.block(0).sadd(-1.0, 1.0, src.block(0));
+        this->solve_inner(*F_matrix, *preconditioner_F, dst.block(0), tmp.block(0), maxit, tol);
+    }
+
+protected:
+    // Store the blocks of the system and the inner solver parameters, and
+    // initialize the preconditioner of F.
+    void initialize_blocks(const TrilinosWrappers::SparseMatrix &F_matrix_,
+                           const TrilinosWrappers::SparseMatrix &B_matrix_,
+                           const TrilinosWrappers::SparseMatrix &Bt_matrix_,
+                           const unsigned int &maxit_, const double &tol_,
+                           const bool &use_ilu_)
+    {
+        const bool same_matrix = (F_matrix == &F_matrix_);
+
+        F_matrix = &F_matrix_;
+        B_matrix = &B_matrix_;
+        Bt_matrix = &Bt_matrix_;
+        maxit = maxit_;
+        tol = tol_;
+        use_ilu = use_ilu_;
+
+        if (this->reuse_hierarchy && same_matrix && this->refresh_inner_preconditioner(preconditioner_F))
+            return;
+
+        this->initialize_velocity_preconditioner(preconditioner_F, *F_matrix, use_ilu);
+    }
+
+    // Approximate dst = S^{-1} src.
+    virtual void vmult_schur(TrilinosWrappers::MPI::Vector &dst,
+                             const TrilinosWrappers::MPI::Vector &src) const = 0;
+
+    const TrilinosWrappers::SparseMatrix *F_matrix = nullptr;
+
+    const TrilinosWrappers::SparseMatrix *B_matrix;
+
+    const TrilinosWrappers::SparseMatrix *Bt_matrix;
+
+    std::shared_ptr<TrilinosWrappers::PreconditionBase> preconditioner_F;
+
+    mutable TrilinosWrappers::MPI::BlockVector tmp;
+
+    unsigned int maxit;
+
+    double tol;
+
+    bool use_ilu;
+};
+
+// ---------------------------------------------------------------
+// Class: PreconditionPCD
+//
+// Description:
+//   Pressure convection-diffusion preconditioner (Kay, Loghin and
+//   Wathen). The Schur complement is approximated by
+//
+//       S^{-1} ~ Mp^{-1} Fp Ap^{-1},
+//
+//   where Mp is the pressure mass matrix, Ap the pressure Laplacian
+//   and Fp = (alpha_0/dt) Mp + nu Ap + N_p(u*) the convection-diffusion
+//   operator of the momentum equation discretized on the pressure
+//   space. The iteration counts are nearly independent of the mesh
+//   size and only mildly dependent on Re and dt.
+//
+//   Ap and Mp do not change between time steps: their inner
+//   preconditioners are only built at the first call. As in the
+//   solvers, the pressure mass matrix is passed scaled by 1/nu.
+// ---------------------------------------------------------------
+class PreconditionPCD : public PreconditionBlockTriangular
+{
+public:
+    // Initialize the preconditioner.
+    //
+    // Parameters:
+    //   F_matrix_   - (1,1)-block of the system.
+    //   B_matrix_   - (2,1)-block of the system.
+    //   Bt_matrix_  - (1,2)-block of the system.
+    //   Mp_matrix_  - pressure mass matrix divided by nu (constant).
+    //   Ap_matrix_  - pressure Laplacian (constant).
+    //   Fp_matrix_  - pressure convection-diffusion operator.
+    //   nu_         - viscosity.
+    //   maxit_      - Maximum iterations for inner solvers.
+    //   tol_        - Tolerance for convergence in inner solvers.
+    //   use_ilu     - Boolean flag to enable ILU factorization in inner solvers.
+    void initialize(const TrilinosWrappers::SparseMatrix &F_matrix_,
+                    const TrilinosWrappers::SparseMatrix &B_matrix_,
+                    const TrilinosWrappers::SparseMatrix &Bt_matrix_,
+                    const TrilinosWrappers::SparseMatrix &Mp_matrix_,
+                    const TrilinosWrappers::SparseMatrix &Ap_matrix_,
+                    const TrilinosWrappers::SparseMatrix &Fp_matrix_,
+                    const double &nu_,
+                    const unsigned int &maxit_, const double &tol_,
+                    const bool &use_ilu)
+    {
+        this->initialize_blocks(F_matrix_, B_matrix_, Bt_matrix_, maxit_, tol_, use_ilu);
+
+        Fp_matrix = &Fp_matrix_;
+        nu = nu_;
+
+        if (Mp_matrix != &Mp_matrix_ || Ap_matrix != &Ap_matrix_)
+        {
+            Mp_matrix = &Mp_matrix_;
+            Ap_matrix = &Ap_matrix_;
+            this->initialize_inner_preconditioner(preconditioner_Mp, *Mp_matrix, use_ilu);
+            this->initialize_inner_preconditioner(preconditioner_Ap, *Ap_matrix, use_ilu);
+        }
+    }
+
+protected:
+    void vmult_schur(TrilinosWrappers::MPI::Vector &dst,
+                     const TrilinosWrappers::MPI::Vector &src) const override
+    {
+        tmp_p.reinit(src, true);
+
+        // Mp^{-1} = (1/nu) (Mp/nu)^{-1}.
+        this->solve_inner(*Ap_matrix, *preconditioner_Ap, tmp_p, src, maxit, tol);
+        Fp_matrix->vmult(dst, tmp_p);
+        tmp_p.equ(1.0 / nu, dst);
+        this->solve_inner(*Mp_matrix, *preconditioner_Mp, dst, tmp_p, maxit, tol);
+    }
+
+private:
+    const TrilinosWrappers::SparseMatrix *Mp_matrix = nullptr;
+
+    const TrilinosWrappers::SparseMatrix *Ap_matrix = nullptr;
+
+    const TrilinosWrappers::SparseMatrix *Fp_matrix = nullptr;
+
+    double nu;
+
+    std::shared_ptr<TrilinosWrappers::PreconditionBase> preconditioner_Mp;
+
+    std::shared_ptr<TrilinosWrappers::PreconditionBase> preconditioner_Ap;
+
+    mutable TrilinosWrappers::MPI::Vector tmp_p;
+};
+
+// ---------------------------------------------------------------
+// Class: PreconditionLSC
+//
+// Description:
+//   Least-squares commutator preconditioner (Elman et al.). The Schur
+//   complement is approximated by
+//
+//       S^{-1} ~ L^{-1} (B Q^{-1} F Q^{-1} B^T) L^{-1},  L = B Q^{-1} B^T,
+//
+//   with Q the diagonal of the velocity mass matrix. Unlike PCD it is
+//   built from the blocks of the system only, so it needs no extra
+//   operator on the pressure space. L does not change between time
+//   steps and is computed once, unless B and B^T are reassembled at
+//   every step (stabilization).
+// ---------------------------------------------------------------
+class PreconditionLSC : public PreconditionBlockTriangular
+{
+public:
+    // Initialize the preconditioner.
+    //
+    // Parameters:
+    //   F_matrix_   - (1,1)-block of the system.
+    //   B_matrix_   - (2,1)-block of the system.
+    //   Bt_matrix_  - (1,2)-block of the system.
+    //   Mu_matrix_  - velocity mass matrix, whose diagonal defines Q (constant).
+    //   vec         - Block vector providing the structure of the blocks.
+    //   maxit_      - Maximum iterations for inner solvers.
+    //   tol_        - Tolerance for convergence in inner solvers.
+    //   use_ilu     - Boolean flag to enable ILU factorization in inner solvers.
+    void initialize(const TrilinosWrappers::SparseMatrix &F_matrix_,
+                    const TrilinosWrappers::SparseMatrix &B_matrix_,
+                    const TrilinosWrappers::SparseMatrix &Bt_matrix_,
+                    const TrilinosWrappers::SparseMatrix &Mu_matrix_,
+                    const TrilinosWrappers::MPI::BlockVector &vec,
+                    const unsigned int &maxit_, const double &tol_,
+                    const bool &use_ilu)
+    {
+        this->initialize_blocks(F_matrix_, B_matrix_, Bt_matrix_, maxit_, tol_, use_ilu);
+
+        if (L_ready && !this->variable_coupling)
+            return;
+
+        // B and B^T have opposite signs, so L = B Q^{-1} B^T is
+        // positive if computed as B (-Q^{-1}) B^T.
+        Qinv_vector.reinit(vec.block(0));
+        negQinv_vector.reinit(vec.block(0));
+        for (unsigned int index : Qinv_vector.locally_owned_elements())
+        {
+            Qinv_vector[index] = 1.0 / Mu_matrix_.diag_element(index);
+            negQinv_vector[index] = -Qinv_vector[index];
+        }
+
+        B_matrix->mmult(L_matrix, *Bt_matrix, negQinv_vector);
+
+        this->initialize_inner_preconditioner(preconditioner_L, L_matrix, use_ilu);
+
+        L_ready = true;
+    }
+
+protected:
+    void vmult_schur(TrilinosWrappers::MPI::Vector &dst,
+                     const TrilinosWrappers::MPI::Vector &src) const override
+    {
+        tmp_p.reinit(src, true);
+        tmp_u.reinit(Qinv_vector, true);
+        tmp_u_2.reinit(Qinv_vector, true);
+
+        // tmp_p = L^{-1} src
+        this->solve_inner(L_matrix, *preconditioner_L, tmp_p, src, maxit, tol);
+
+        // dst = -B Q^{-1} F Q^{-1} B^T tmp_p (the sign accounts for B^T = -B^T).
+        Bt_matrix->vmult(tmp_u, tmp_p);
+        tmp_u.scale(Qinv_vector);
+        F_matrix->vmult(tmp_u_2, tmp_u);
+        tmp_u_2.scale(Qinv_vector);
+        B_matrix->vmult(tmp_p, tmp_u_2);
+        tmp_p *= -1.0;
+
+        // dst = L^{-1} dst
+        this->solve_inner(L_matrix, *preconditioner_L, dst, tmp_p, maxit, tol);
+    }
+
+private:
+    TrilinosWrappers::MPI::Vector Qinv_vector;
+
+    TrilinosWrappers::MPI::Vector negQinv_vector;
+
+    TrilinosWrappers::SparseMatrix L_matrix;
+
+    std::shared_ptr<TrilinosWrappers::PreconditionBase> preconditioner_L;
+
+    bool L_ready = false;
+
+    mutable TrilinosWrappers::MPI::Vector tmp_p;
+
+    mutable TrilinosWrappers::MPI::Vector tmp_u;
+
+    mutable TrilinosWrappers::MPI::Vector tmp_u_2;
+};
+
+// ---------------------------------------------------------------
+// Class: PreconditionCahouetChabard
+//
+// Description:
+//   Cahouet-Chabard preconditioner for the generalized Stokes part
+//   F ~ sigma M + nu A of the momentum operator. The Schur complement
+//   is approximated by
+//
+//       S^{-1} ~ sigma Ap^{-1} + nu Mp^{-1},   sigma = alpha_0 / dt,
+//
+//   which is robust with respect to dt and the mesh size. It does not
+//   account for convection, so it is best suited to moderate Re. Since
+//   the solvers assemble Mp/nu, the second term is simply (Mp/nu)^{-1}.
+// ---------------------------------------------------------------
+class PreconditionCahouetChabard : public PreconditionBlockTriangular
+{
+public:
+    // Initialize the preconditioner.
+    //
+    // Parameters:
+    //   F_matrix_   - (1,1)-block of the system.
+    //   B_matrix_   - (2,1)-block of the system.
+    //   Bt_matrix_  - (1,2)-block of the system.
+    //   Mp_matrix_  - pressure mass matrix divided by nu (constant).
+    //   Ap_matrix_  - pressure Laplacian (constant).
+    //   sigma_      - coefficient of the velocity mass matrix in F (alpha_0/dt).
+    //   maxit_      - Maximum iterations for inner solvers.
+    //   tol_        - Tolerance for convergence in inner solvers.
+    //   use_ilu     - Boolean flag to enable ILU factorization in inner solvers.
+    void initialize(const TrilinosWrappers::SparseMatrix &F_matrix_,
+                    const TrilinosWrappers::SparseMatrix &B_matrix_,
+                    const TrilinosWrappers::SparseMatrix &Bt_matrix_,
+                    const TrilinosWrappers::SparseMatrix &Mp_matrix_,
+                    const TrilinosWrappers::SparseMatrix &Ap_matrix_,
+                    const double &sigma_,
+                    const unsigned int &maxit_, const double &tol_,
+                    const bool &use_ilu)
+    {
+        this->initialize_blocks(F_matrix_, B_matrix_, Bt_matrix_, maxit_, tol_, use_ilu);
+
+        sigma = sigma_;
+
+        if (Mp_matrix != &Mp_matrix_ || Ap_matrix != &Ap_matrix_)
+        {
+            Mp_matrix = &Mp_matrix_;
+            Ap_matrix = &Ap_matrix_;
+            this->initialize_inner_preconditioner(preconditioner_Mp, *Mp_matrix, use_ilu);
+            this->initialize_inner_preconditioner(preconditioner_Ap, *Ap_matrix, use_ilu);
+        }
+    }
+
+protected:
+    void vmult_schur(TrilinosWrappers::MPI::Vector &dst,
+                     const TrilinosWrappers::MPI::Vector &src) const override
+    {
+        tmp_p.reinit(src, true);
+
+        this->solve_inner(*Ap_matrix, *preconditioner_Ap, tmp_p, src, maxit, tol);
+        this->solve_inner(*Mp_matrix, *preconditioner_Mp, dst, src, maxit, tol);
+        dst.add(sigma, tmp_p);
+    }
+
+private:
+    const TrilinosWrappers::SparseMatrix *Mp_matrix = nullptr;
+
+    const TrilinosWrappers::SparseMatrix *Ap_matrix = nullptr;
+
+    std::shared_ptr<TrilinosWrappers::PreconditionBase> preconditioner_Mp;
+
+    std::shared_ptr<TrilinosWrappers::PreconditionBase> preconditioner_Ap;
+
+    double sigma;
+
+    mutable TrilinosWrappers::MPI::Vector tmp_p;
+};
+
+// ---------------------------------------------------------------
+// Class: PreconditionAugmentedLagrangian
+//
+// Description:
+//   Augmented-Lagrangian preconditioner for systems whose momentum
+//   block contains the grad-div term gamma (div u, div v). For large
+//   gamma the Schur complement is dominated by the grad-div term and
+//   can be approximated by
+//
+//       S^{-1} ~ (nu + gamma) Mp^{-1} = ((nu + gamma) / nu) (Mp/nu)^{-1},
+//
+//   which gives outer iteration counts nearly independent of the mesh
+//   size and of Re. The pressure mass matrix is passed scaled by 1/nu,
+//   as assembled by the solvers, and does not change between calls.
+// ---------------------------------------------------------------
+class PreconditionAugmentedLagrangian : public PreconditionBlockTriangular
+{
+public:
+    // Initialize the preconditioner.
+    //
+    // Parameters:
+    //   F_matrix_   - (1,1)-block of the system, including the grad-div term.
+    //   B_matrix_   - (2,1)-block of the system.
+    //   Bt_matrix_  - (1,2)-block of the system.
+    //   Mp_matrix_  - pressure mass matrix divided by nu (constant).
+    //   nu_         - viscosity.
+    //   gamma_      - grad-div coefficient.
+    //   maxit_      - Maximum iterations for inner solvers.
+    //   tol_        - Tolerance for convergence in inner solvers.
+    //   use_ilu     - Boolean flag to enable ILU factorization in inner solvers.
+    void initialize(const TrilinosWrappers::SparseMatrix &F_matrix_,
+                    const TrilinosWrappers::SparseMatrix &B_matrix_,
+                    const TrilinosWrappers::SparseMatrix &Bt_matrix_,
+                    const TrilinosWrappers::SparseMatrix &Mp_matrix_,
+                    const double &nu_, const double &gamma_,
+                    const unsigned int &maxit_, const double &tol_,
+                    const bool &use_ilu)
+    {
+        this->initialize_blocks(F_matrix_, B_matrix_, Bt_matrix_, maxit_, tol_, use_ilu);
+
+        scaling = (nu_ + gamma_) / nu_;
+
+        // Mp/nu only changes with nu (Reynolds sweeps of the steady solver).
+        if (Mp_matrix != &Mp_matrix_ || Mp_nu != nu_)
+        {
+            Mp_matrix = &Mp_matrix_;
+            Mp_nu = nu_;
+            this->initialize_inner_preconditioner(preconditioner_Mp, *Mp_matrix, use_ilu);
+        }
+    }
+
+protected:
+    void vmult_schur(TrilinosWrappers::MPI::Vector &dst,
+                     const TrilinosWrappers::MPI::Vector &src) const override
+    {
+        this->solve_inner(*Mp_matrix, *preconditioner_Mp, dst, src, maxit, tol);
+        dst *= scaling;
+    }
+
+private:
+    const TrilinosWrappers::SparseMatrix *Mp_matrix = nullptr;
+
+    std::shared_ptr<TrilinosWrappers::PreconditionBase> preconditioner_Mp;
+
+    double Mp_nu = 0.0;                                         // Viscosity Mp_matrix was scaled with at the last build
+
+    double scaling;
+};
+
 
-#endif
\ No newline at end of file
+#endif
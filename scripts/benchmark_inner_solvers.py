@@ -0,0 +1,78 @@
+import os
+import re
+import subprocess as sp
+import argparse
+
+# Compare the total wall time of the monolithic solver when the block
+# preconditioners use inner Krylov solves (inner_cycles=0, FGMRES outer
+# solver) and when they use a fixed number of AMG V-cycles (GMRES outer
+# solver), on the 2D and 3D cylinder problems.
+#
+# The script must be run from the build directory, e.g.
+#   $ python3 ../scripts/benchmark_inner_solvers.py -n 4 --cycles 1 2
+
+# Choices of the main menu of the executable.
+PROBLEMS = {"2D": 3, "3D": 4}
+
+
+def write_config(base_config, path, overrides):
+    with open(base_config) as f:
+        lines = f.readlines()
+
+    with open(path, "w") as f:
+        for line in lines:
+            match = re.match(r"^([\w_]+)\s*=", line)
+            if match and match.group(1) in overrides:
+                continue
+            f.write(line)
+        for key, value in overrides.items():
+            f.write(f"{key}={value}\n")
+
+
+def run_case(executable, n_procs, config_path, choice):
+    command = ["mpirun", "-n", str(n_procs), executable, config_path]
+    result = sp.run(command, input=f"{choice}\n", capture_output=True, text=True)
+    if result.returncode != 0:
+        print(result.stdout)
+        print(result.stderr)
+        raise RuntimeError(f"Run failed: {' '.join(command)}")
+
+    elapsed = re.search(r"Elapsed time: ([0-9.eE+-]+) s", result.stdout)
+    outer = [int(n) for n in re.findall(r"(\d+) F?GMRES iterations", result.stdout)]
+
+    return float(elapsed.group(1)), sum(outer), len(outer)
+
+
+def main():
+    script_dir = os.path.dirname(os.path.abspath(__file__))
+
+    parser = argparse.ArgumentParser(description="Inner solves vs fixed V-cycles benchmark")
+    parser.add_argument("-n", "--n-procs", type=int, default=1, help="number of MPI processes")
+    parser.add_argument("--executable", default="./main", help="solver executable")
+    parser.add_argument("--config", default=os.path.join(script_dir, "..", "parameters.config"),
+                        help="base parameters file")
+    parser.add_argument("--cycles", type=int, nargs="+", default=[1, 2],
+                        help="numbers of V-cycles per inner block inverse to test")
+    parser.add_argument("--problems", nargs="+", default=list(PROBLEMS.keys()), choices=PROBLEMS.keys())
+    args = parser.parse_args()
+
+    modes = [("inner solves", {"inner_cycles": 0})]
+    modes += [(f"{c} V-cycle(s)", {"inner_cycles": c}) for c in args.cycles]
+
+    print(f"{'problem':<8} {'mode':<16} {'time [s]':>10} {'steps':>6} {'outer its/step':>15}")
+
+    for problem in args.problems:
+        for name, overrides in modes:
+            config_path = os.path.abspath(f"benchmark_{problem}_{overrides['inner_cycles']}.config")
+            write_config(args.config, config_path, overrides)
+
+            elapsed, outer, steps = run_case(args.executable, args.n_procs, config_path,
+                                             PROBLEMS[problem])
+            per_step = outer / steps if steps else float("nan")
+            print(f"{problem:<8} {name:<16} {elapsed:>10.2f} {steps:>6} {per_step:>15.1f}")
+
+            os.remove(config_path)
+
+
+if __name__ == "__main__":
+    main()
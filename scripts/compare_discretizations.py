@@ -0,0 +1,84 @@
+import os
+import re
+import subprocess as sp
+import argparse
+
+# Compare the Taylor-Hood pair P2-P1 with the stabilized equal-order pair
+# P1-P1 on the steady 2D cylinder benchmark (Re = 20): number of DoFs, drag
+# and lift coefficients, their error with respect to the reference values
+# of Schafer and Turek, and total wall time.
+#
+# The script must be run from the build directory, e.g.
+#   $ python3 ../scripts/compare_discretizations.py -n 4
+
+# Choice of the main menu of the executable (steady 2D solver).
+STEADY_2D = 1
+
+# Reference coefficients of the 2D-1 benchmark.
+REFERENCE_DRAG = 5.57954
+REFERENCE_LIFT = 0.010618
+
+DISCRETIZATIONS = {
+    "P2-P1": {"degree_velocity": 2, "degree_pressure": 1, "stabilization": 0},
+    "P1-P1 SUPG/PSPG": {"degree_velocity": 1, "degree_pressure": 1, "stabilization": 1},
+}
+
+
+def write_config(base_config, path, overrides):
+    with open(base_config) as f:
+        lines = f.readlines()
+
+    with open(path, "w") as f:
+        for line in lines:
+            match = re.match(r"^([\w_]+)\s*=", line)
+            if match and match.group(1) in overrides:
+                continue
+            f.write(line)
+        for key, value in overrides.items():
+            f.write(f"{key}={value}\n")
+
+
+def run_case(executable, n_procs, config_path):
+    command = ["mpirun", "-n", str(n_procs), executable, config_path]
+    result = sp.run(command, input=f"{STEADY_2D}\n", capture_output=True, text=True)
+    if result.returncode != 0:
+        print(result.stdout)
+        print(result.stderr)
+        raise RuntimeError(f"Run failed: {' '.join(command)}")
+
+    dofs = re.search(r"total\s+=\s+(\d+)", result.stdout)
+    drag = re.findall(r"Total Drag = ([0-9.eE+-]+)", result.stdout)
+    lift = re.findall(r"Total Lift = ([0-9.eE+-]+)", result.stdout)
+    elapsed = re.search(r"Elapsed time: ([0-9.eE+-]+) s", result.stdout)
+
+    return int(dofs.group(1)), float(drag[-1]), float(lift[-1]), float(elapsed.group(1))
+
+
+def main():
+    script_dir = os.path.dirname(os.path.abspath(__file__))
+
+    parser = argparse.ArgumentParser(description="P2-P1 vs stabilized P1-P1 comparison")
+    parser.add_argument("-n", "--n-procs", type=int, default=1, help="number of MPI processes")
+    parser.add_argument("--executable", default="./main", help="solver executable")
+    parser.add_argument("--config", default=os.path.join(script_dir, "..", "parameters.config"),
+                        help="base parameters file")
+    args = parser.parse_args()
+
+    print(f"{'discretization':<18} {'DoFs':>9} {'cD':>10} {'err cD':>9} "
+          f"{'cL':>10} {'err cL':>9} {'time [s]':>10}")
+
+    for index, (name, overrides) in enumerate(DISCRETIZATIONS.items()):
+        config_path = os.path.abspath(f"compare_discretizations_{index}.config")
+        write_config(args.config, config_path, overrides)
+
+        dofs, drag, lift, elapsed = run_case(args.executable, args.n_procs, config_path)
+        drag_error = abs(drag - REFERENCE_DRAG) / REFERENCE_DRAG
+        lift_error = abs(lift - REFERENCE_LIFT) / REFERENCE_LIFT
+        print(f"{name:<18} {dofs:>9} {drag:>10.5f} {drag_error:>8.2%} "
+              f"{lift:>10.6f} {lift_error:>8.2%} {elapsed:>10.2f}")
+
+        os.remove(config_path)
+
+
+if __name__ == "__main__":
+    main()
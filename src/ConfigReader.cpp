@@ -2,7 +2,11 @@
 #include <iostream>
 #include <fstream>
 #include <string>
-ConfigReader::ConfigReader()
+#include <sstream>
+#include <algorithm>
+#include <stdexcept>
+ConfigReader::ConfigReader(const std::filesystem::path &configFilePath_)
+    : configFilePath(configFilePath_)
 {
     requiredVariables = {
         "mesh_2d_path",
@@ -26,13 +30,22 @@ ConfigReader::ConfigReader()
 
 auto ConfigReader::readConfigFile() -> bool
 {
-    std::ifstream file("../parameters.config");
+    std::ifstream file(configFilePath);
     if (!file.is_open())
     {
         std::cerr << "Error: Config file not found." << '\n';
         return false;
     }
 
+    // An invalid value is reported and its option keeps the default, and
+    // the rest of the file is still read: the result is false if any value
+    // was rejected.
+    bool valid = true;
+    const auto reject = [&valid](const std::string &message) {
+        std::cerr << "Error: " << message << " Keeping the default value." << '\n';
+        valid = false;
+    };
+
     std::string line;
     while (std::getline(file, line))
     {
@@ -47,49 +60,186 @@ auto ConfigReader::readConfigFile() -> bool
             std::string variableName = match[1];
             std::string variableValue = match[2];
 
-            if (variableName == "mesh_2d_path")
-            {
-                mesh2DPath = variableValue;
-            }
-            else if (variableName == "mesh_3d_path")
-            {
-                mesh3DPath = variableValue;
-            }
-            else if (variableName == "degree_velocity")
+            // std::stoi/std::stod throw on a value that is not a number or
+            // does not fit: the option is rejected like any other invalid
+            // value.
+            try
             {
-                degreeVelocity = std::stoi(variableValue);
-            }
-            else if (variableName == "degree_pressure")
-            {
-                degreePressure = std::stoi(variableValue);
-            }
-            else if (variableName == "T")
-            {
-                simulationPeriod = std::stod(variableValue);
-            }
-            else if (variableName == "deltat")
-            {
-                timeStep = std::stod(variableValue);
+                if (variableName == "mesh_2d_path")
+                {
+                    mesh2DPath = variableValue;
+                }
+                else if (variableName == "mesh_3d_path")
+                {
+                    mesh3DPath = variableValue;
+                }
+                else if (variableName == "degree_velocity")
+                {
+                    degreeVelocity = std::stoi(variableValue);
+                }
+                else if (variableName == "degree_pressure")
+                {
+                    degreePressure = std::stoi(variableValue);
+                }
+                else if (variableName == "T")
+                {
+                    simulationPeriod = std::stod(variableValue);
+                }
+                else if (variableName == "deltat")
+                {
+                    timeStep = std::stod(variableValue);
+                }
+                else if (variableName == "Re")
+                {
+                    Re = std::stod(variableValue);
+                }
+                else if (variableName == "probes_2d_path")
+                {
+                    probes2DPath = variableValue;
+                }
+                else if (variableName == "probes_3d_path")
+                {
+                    probes3DPath = variableValue;
+                }
+                else if (variableName == "extrapolation_depth")
+                {
+                    solverOptions.extrapolation_depth = std::stoi(variableValue);
+                }
+                else if (variableName == "projection_depth")
+                {
+                    solverOptions.projection_depth = std::stoi(variableValue);
+                }
+                else if (variableName == "inner_tolerance")
+                {
+                    solverOptions.inner_tolerance = std::stod(variableValue);
+                }
+                else if (variableName == "inner_cycles")
+                {
+                    solverOptions.inner_cycles = std::stoi(variableValue);
+                }
+                else if (variableName == "mixed_precision")
+                {
+                    solverOptions.mixed_precision = std::stoi(variableValue) != 0;
+                }
+                else if (variableName == "velocity_multigrid")
+                {
+                    solverOptions.velocity_multigrid = std::stoi(variableValue) != 0;
+                }
+                else if (variableName == "preconditioner")
+                {
+                    solverOptions.preconditioner = variableValue;
+                }
+                else if (variableName == "direct_solver")
+                {
+                    if (variableValue != "none" && variableValue != "klu" && variableValue != "umfpack" &&
+                        variableValue != "mumps" && variableValue != "superludist")
+                        reject("direct_solver must be none, klu, umfpack, mumps or superludist.");
+                    else
+                        solverOptions.direct_solver = variableValue;
+                }
+                else if (variableName == "gmres_orthogonalization")
+                {
+                    if (variableValue != "mgs" && variableValue != "cgs2")
+                        reject("gmres_orthogonalization must be mgs or cgs2.");
+                    else
+                        solverOptions.gmres_orthogonalization = variableValue;
+                }
+                else if (variableName == "grad_div")
+                {
+                    solverOptions.grad_div = std::stod(variableValue);
+                }
+                else if (variableName == "stabilization")
+                {
+                    solverOptions.stabilization = std::stoi(variableValue) != 0;
+                }
+                else if (variableName == "geometry_cache")
+                {
+                    solverOptions.geometry_cache = std::stoi(variableValue) != 0;
+                }
+                else if (variableName == "reynolds_sweep")
+                {
+                    // Comma-separated list, e.g. reynolds_sweep=20,40,60,80,100
+                    std::vector<double> reynolds_numbers;
+                    std::stringstream values(variableValue);
+                    std::string value;
+                    while (std::getline(values, value, ','))
+                    {
+                        if (!value.empty())
+                            reynolds_numbers.push_back(std::stod(value));
+                    }
+
+                    if (std::any_of(reynolds_numbers.begin(), reynolds_numbers.end(), [](const double re) { return re <= 0.0; }))
+                        reject("reynolds_sweep must only contain positive values.");
+                    else
+                        solverOptions.reynolds_sweep = reynolds_numbers;
+                }
+                else if (variableName == "newton_max_iterations")
+                {
+                    const int newton_max_iterations = std::stoi(variableValue);
+                    if (newton_max_iterations <= 0)
+                        reject("newton_max_iterations must be positive.");
+                    else
+                        solverOptions.newton_max_iterations = newton_max_iterations;
+                }
+                else if (variableName == "newton_tolerance")
+                {
+                    const double newton_tolerance = std::stod(variableValue);
+                    if (newton_tolerance <= 0.0 || newton_tolerance >= 1.0)
+                        reject("newton_tolerance must be in (0, 1).");
+                    else
+                        solverOptions.newton_tolerance = newton_tolerance;
+                }
+                else if (variableName == "picard_iterations")
+                {
+                    solverOptions.picard_iterations = std::stoi(variableValue);
+                }
+                else if (variableName == "line_search_steps")
+                {
+                    solverOptions.line_search_steps = std::stoi(variableValue);
+                }
+                else if (variableName == "nonlinear_solver")
+                {
+                    if (variableValue != "newton" && variableValue != "anderson")
+                        reject("nonlinear_solver must be newton or anderson.");
+                    else
+                        solverOptions.nonlinear_solver = variableValue;
+                }
+                else if (variableName == "anderson_depth")
+                {
+                    solverOptions.anderson_depth = std::stoi(variableValue);
+                }
+                else if (variableName == "bdf_order")
+                {
+                    const int bdf_order = std::stoi(variableValue);
+                    if (bdf_order != 1 && bdf_order != 2)
+                        reject("bdf_order must be 1 or 2.");
+                    else
+                        solverOptions.bdf_order = bdf_order;
+                }
+                else
+                {
+                    std::cerr << "Warning: Unknown variable '" << variableName << "' in config file." << '\n';
+                }
             }
-            else if (variableName == "Re")
+            catch (const std::invalid_argument &)
             {
-                Re = std::stod(variableValue);
+                reject("Invalid value '" + variableValue + "' for " + variableName + ".");
             }
-            else
+            catch (const std::out_of_range &)
             {
-                std::cerr << "Warning: Unknown variable '" << variableName << "' in config file." << '\n';
+                reject("Value '" + variableValue + "' for " + variableName + " is out of range.");
             }
         }
         else
         {
             std::cerr << "Error: Invalid format in line: " << line << '\n';
-            return false;
+            valid = false;
         }
     }
 
     file.close();
 
-    return true;
+    return valid;
 }
 
 auto ConfigReader::ensureVariablesSet() -> void
@@ -236,3 +386,18 @@ auto ConfigReader::getRe() const -> double
 {
     return Re;
 }
+
+auto ConfigReader::getProbes2DPath() const -> std::filesystem::path
+{
+    return probes2DPath;
+}
+
+auto ConfigReader::getProbes3DPath() const -> std::filesystem::path
+{
+    return probes3DPath;
+}
+
+auto ConfigReader::getSolverOptions() const -> SolverOptions
+{
+    return solverOptions;
+}
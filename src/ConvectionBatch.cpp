@@ -0,0 +1,307 @@
+#include "../include/ConvectionBatch.hpp"
+
+// The kernel is cloned for AVX-512 and AVX2: the dynamic loader picks
+// the variant matching the CPU the first time the function is called,
+// so a single executable runs at full speed on every node.
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__)
+#define CONVECTION_BATCH_TARGETS __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define CONVECTION_BATCH_TARGETS
+#endif
+
+namespace
+{
+    // Number of shape functions of the scalar P_k element on a simplex.
+    unsigned int n_simplex_dofs(const unsigned int dim, const unsigned int degree)
+    {
+        unsigned int n = 1;
+        for (unsigned int d = 1; d <= dim; ++d)
+            n = n * (degree + d) / d;
+        return n;
+    }
+
+    // Kernel body. With DIM and N_S > 0 the loop bounds are compile-time
+    // constants: the loops over the dimension and the shape functions are
+    // fully unrolled and the workspace lives on the stack. DIM = N_S = 0
+    // is the generic version, which reads them from the arguments.
+    template <unsigned int DIM, unsigned int N_S>
+    CONVECTION_BATCH_TARGETS
+    void convection_batch_kernel_impl(const unsigned int n_scalar_dofs,
+                                      const unsigned int n_q,
+                                      const unsigned int dim_,
+                                      const double mass_coefficient,
+                                      const double viscosity,
+                                      const double skew_coefficient,
+                                      const double *__restrict values,
+                                      const double *__restrict gradients,
+                                      const double *__restrict advection,
+                                      const double *__restrict divergence,
+                                      const double *__restrict JxW,
+                                      double *__restrict trial_workspace,
+                                      double *__restrict matrices)
+    {
+        constexpr unsigned int L = convection_batch_lanes;
+        const unsigned int dim = (DIM > 0) ? DIM : dim_;
+        const unsigned int n_s = (N_S > 0) ? N_S : n_scalar_dofs;
+
+        double trial_stack[(N_S > 0) ? N_S * L : 1];
+        double *__restrict trial = (N_S > 0) ? trial_stack : trial_workspace;
+
+        std::fill(matrices, matrices + n_s * n_s * L, 0.0);
+
+        for (unsigned int q = 0; q < n_q; ++q)
+        {
+            const double *val_q = values + q * n_s * L;
+            const double *grad_q = gradients + q * n_s * dim * L;
+            const double *adv_q = advection + q * dim * L;
+            const double *div_q = divergence + q * L;
+            const double *JxW_q = JxW + q * L;
+
+            // Trial part of the mass, convective and skew-symmetric terms
+            // ------
+            // t_b = (m + s ∇·u*) ϕ_b + ∇ϕ_b·u*
+            // ------
+            for (unsigned int b = 0; b < n_s; ++b)
+            {
+                double *t = trial + b * L;
+                for (unsigned int l = 0; l < L; ++l)
+                    t[l] = (mass_coefficient + skew_coefficient * div_q[l]) * val_q[b * L + l];
+                for (unsigned int d = 0; d < dim; ++d)
+                    for (unsigned int l = 0; l < L; ++l)
+                        t[l] += grad_q[(b * dim + d) * L + l] * adv_q[d * L + l];
+            }
+
+            for (unsigned int a = 0; a < n_s; ++a)
+            {
+                // Test functions weighted by the quadrature
+                double w[L];
+                double w_grad[3][L];
+                for (unsigned int l = 0; l < L; ++l)
+                    w[l] = JxW_q[l] * val_q[a * L + l];
+                for (unsigned int d = 0; d < dim; ++d)
+                    for (unsigned int l = 0; l < L; ++l)
+                        w_grad[d][l] = viscosity * JxW_q[l] * grad_q[(a * dim + d) * L + l];
+
+                // ------
+                // C_ab += JxW (ϕ_a t_b + ν ∇ϕ_a·∇ϕ_b)
+                // ------
+                for (unsigned int b = 0; b < n_s; ++b)
+                {
+                    double *C = matrices + (a * n_s + b) * L;
+                    const double *t = trial + b * L;
+                    for (unsigned int l = 0; l < L; ++l)
+                        C[l] += w[l] * t[l];
+                    for (unsigned int d = 0; d < dim; ++d)
+                        for (unsigned int l = 0; l < L; ++l)
+                            C[l] += w_grad[d][l] * grad_q[(b * dim + d) * L + l];
+                }
+            }
+        }
+    }
+
+    // Signature shared by all the instantiations of the kernel.
+    using ConvectionBatchKernel = void (*)(const unsigned int, const unsigned int, const unsigned int,
+                                           const double, const double, const double,
+                                           const double *, const double *, const double *,
+                                           const double *, const double *, double *, double *);
+
+    // Specialized instantiation for (dim, scalar dofs), or nullptr if none.
+    // The instantiated pairs are P1 and P2 velocities in 2D and 3D, i.e.
+    // the P2-P1 (Taylor-Hood) and the stabilized P1-P1 discretizations.
+    ConvectionBatchKernel specialized_kernel(const unsigned int dim, const unsigned int n_scalar_dofs)
+    {
+        if (dim == 2 && n_scalar_dofs == n_simplex_dofs(2, 1))
+            return &convection_batch_kernel_impl<2, 3>;
+        if (dim == 2 && n_scalar_dofs == n_simplex_dofs(2, 2))
+            return &convection_batch_kernel_impl<2, 6>;
+        if (dim == 3 && n_scalar_dofs == n_simplex_dofs(3, 1))
+            return &convection_batch_kernel_impl<3, 4>;
+        if (dim == 3 && n_scalar_dofs == n_simplex_dofs(3, 2))
+            return &convection_batch_kernel_impl<3, 10>;
+        return nullptr;
+    }
+}
+
+void convection_batch_kernel(const unsigned int n_scalar_dofs,
+                             const unsigned int n_q,
+                             const unsigned int dim,
+                             const double mass_coefficient,
+                             const double viscosity,
+                             const double skew_coefficient,
+                             const double *values,
+                             const double *gradients,
+                             const double *advection,
+                             const double *divergence,
+                             const double *JxW,
+                             double *trial,
+                             double *matrices)
+{
+    ConvectionBatchKernel kernel = specialized_kernel(dim, n_scalar_dofs);
+    if (kernel == nullptr)
+        kernel = &convection_batch_kernel_impl<0, 0>;
+
+    kernel(n_scalar_dofs, n_q, dim, mass_coefficient, viscosity, skew_coefficient,
+           values, gradients, advection, divergence, JxW, trial, matrices);
+}
+
+std::string convection_batch_kernel_name(const unsigned int dim, const unsigned int degree)
+{
+    std::string instruction_set = "generic";
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__)
+    if (__builtin_cpu_supports("avx512f"))
+        instruction_set = "AVX-512";
+    else if (__builtin_cpu_supports("avx2"))
+        instruction_set = "AVX2";
+#endif
+
+    const bool specialized = specialized_kernel(dim, n_simplex_dofs(dim, degree)) != nullptr;
+
+    return instruction_set + ", " +
+           (specialized ? "specialized for P" + std::to_string(degree) : std::string("generic P" + std::to_string(degree)));
+}
+
+template <int dim>
+ConvectionBatch<dim>::ConvectionBatch(const FiniteElement<dim> &fe,
+                                      const unsigned int &n_q_,
+                                      const unsigned int &first_component_,
+                                      const double &mass_coefficient_,
+                                      const double &viscosity_,
+                                      const double &skew_coefficient_)
+    : n_q(n_q_)
+    , first_component(first_component_)
+    , mass_coefficient(mass_coefficient_)
+    , viscosity(viscosity_)
+    , skew_coefficient(skew_coefficient_)
+    , n_cells(0)
+{
+    for (unsigned int i = 0; i < fe.dofs_per_cell; ++i)
+    {
+        const auto component_index = fe.system_to_component_index(i);
+        const unsigned int component = component_index.first;
+
+        if (component < first_component || component >= first_component + dim)
+            continue;
+
+        velocity_dofs.push_back(i);
+        velocity_dof_component.push_back(component - first_component);
+        velocity_dof_scalar_index.push_back(component_index.second);
+
+        if (component == first_component)
+        {
+            if (scalar_dofs.size() <= component_index.second)
+                scalar_dofs.resize(component_index.second + 1);
+            scalar_dofs[component_index.second] = i;
+        }
+    }
+
+    AssertThrow(velocity_dofs.size() == dim * scalar_dofs.size(),
+                ExcMessage("ConvectionBatch requires the velocity components to use the same scalar element."));
+
+    const unsigned int n_s = scalar_dofs.size();
+
+    values.assign(n_q * n_s * n_lanes, 0.0);
+    gradients.assign(n_q * n_s * dim * n_lanes, 0.0);
+    advection.assign(n_q * dim * n_lanes, 0.0);
+    divergence.assign(n_q * n_lanes, 0.0);
+    JxW.assign(n_q * n_lanes, 0.0);
+    trial.assign(n_s * n_lanes, 0.0);
+    matrices.assign(n_s * n_s * n_lanes, 0.0);
+}
+
+template <int dim>
+void ConvectionBatch<dim>::add_cell(const FEValues<dim> &fe_values,
+                                    const std::vector<Tensor<1, dim>> &advection_values,
+                                    const std::vector<double> &advection_divergences)
+{
+    Assert(n_cells < n_lanes, ExcInternalError());
+
+    const unsigned int lane = n_cells++;
+    const unsigned int n_s = scalar_dofs.size();
+
+    for (unsigned int q = 0; q < n_q; ++q)
+    {
+        for (unsigned int a = 0; a < n_s; ++a)
+        {
+            values[(q * n_s + a) * n_lanes + lane] =
+                fe_values.shape_value_component(scalar_dofs[a], q, first_component);
+
+            const Tensor<1, dim> gradient =
+                fe_values.shape_grad_component(scalar_dofs[a], q, first_component);
+            for (unsigned int d = 0; d < dim; ++d)
+                gradients[((q * n_s + a) * dim + d) * n_lanes + lane] = gradient[d];
+        }
+
+        for (unsigned int d = 0; d < dim; ++d)
+            advection[(q * dim + d) * n_lanes + lane] = advection_values[q][d];
+        divergence[q * n_lanes + lane] = advection_divergences[q];
+        JxW[q * n_lanes + lane] = fe_values.JxW(q);
+    }
+}
+
+template <int dim>
+void ConvectionBatch<dim>::add_cell(const ReferenceShapes<dim> &shapes,
+                                    const Tensor<2, dim> &inverse_jacobian,
+                                    const double &jacobian_determinant,
+                                    const std::vector<Tensor<1, dim>> &advection_values,
+                                    const std::vector<double> &advection_divergences)
+{
+    Assert(n_cells < n_lanes, ExcInternalError());
+    Assert(shapes.n_q() == n_q, ExcDimensionMismatch(shapes.n_q(), n_q));
+
+    const unsigned int lane = n_cells++;
+    const unsigned int n_s = scalar_dofs.size();
+
+    for (unsigned int q = 0; q < n_q; ++q)
+    {
+        for (unsigned int a = 0; a < n_s; ++a)
+        {
+            values[(q * n_s + a) * n_lanes + lane] = shapes.value(scalar_dofs[a], q);
+
+            const Tensor<1, dim> gradient = shapes.gradient(scalar_dofs[a], q, inverse_jacobian);
+            for (unsigned int d = 0; d < dim; ++d)
+                gradients[((q * n_s + a) * dim + d) * n_lanes + lane] = gradient[d];
+        }
+
+        for (unsigned int d = 0; d < dim; ++d)
+            advection[(q * dim + d) * n_lanes + lane] = advection_values[q][d];
+        divergence[q * n_lanes + lane] = advection_divergences[q];
+        JxW[q * n_lanes + lane] = shapes.weight(q) * jacobian_determinant;
+    }
+}
+
+template <int dim>
+void ConvectionBatch<dim>::compute()
+{
+    // The unused lanes of a partial batch hold stale data of the previous
+    // batch: computing them is cheaper than branching.
+    convection_batch_kernel(scalar_dofs.size(),
+                            n_q,
+                            dim,
+                            mass_coefficient,
+                            viscosity,
+                            skew_coefficient,
+                            values.data(),
+                            gradients.data(),
+                            advection.data(),
+                            divergence.data(),
+                            JxW.data(),
+                            trial.data(),
+                            matrices.data());
+}
+
+template <int dim>
+void ConvectionBatch<dim>::distribute(const unsigned int &lane, FullMatrix<double> &cell_matrix) const
+{
+    Assert(lane < n_cells, ExcIndexRange(lane, 0, n_cells));
+
+    const unsigned int n_s = scalar_dofs.size();
+
+    for (unsigned int i = 0; i < velocity_dofs.size(); ++i)
+        for (unsigned int j = 0; j < velocity_dofs.size(); ++j)
+            if (velocity_dof_component[i] == velocity_dof_component[j])
+                cell_matrix(velocity_dofs[i], velocity_dofs[j]) +=
+                    matrices[(velocity_dof_scalar_index[i] * n_s + velocity_dof_scalar_index[j]) * n_lanes + lane];
+}
+
+template class ConvectionBatch<2>;
+template class ConvectionBatch<3>;
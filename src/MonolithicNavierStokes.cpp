@@ -1,5 +1,8 @@
 #include "../include/MonolithicNavierStokes.hpp"
 #include "../include/preconditioners.hpp"
+#include "../include/Stabilization.hpp"
+#include "../include/ConvectionBatch.hpp"
+#include "../include/SolverFGMRESCGS2.hpp"
 
 template <unsigned int dim>
 void MonolithicNavierStokes<dim>::setup()
@@ -40,6 +43,18 @@ void MonolithicNavierStokes<dim>::setup()
         quadrature = std::make_unique<QGaussSimplex<dim>>(fe->degree + 1);
 
         quadrature_face = std::make_unique<QGaussSimplex<dim - 1>>(fe->degree + 1);
+
+        // Split the shape functions by block, to assemble the single-block
+        // operators with block-local cell matrices.
+        velocity_cell_dofs.clear();
+        pressure_cell_dofs.clear();
+        for (unsigned int i = 0; i < fe->dofs_per_cell; ++i)
+        {
+            if (fe->system_to_component_index(i).first < dim)
+                velocity_cell_dofs.push_back(i);
+            else
+                pressure_cell_dofs.push_back(i);
+        }
     }
 
     // Initialize the DoF handler.
@@ -70,6 +85,12 @@ void MonolithicNavierStokes<dim>::setup()
         pcout << "    velocity = " << n_u << std::endl;
         pcout << "    pressure = " << n_p << std::endl;
         pcout << "    total    = " << n_u + n_p << std::endl;
+
+        // The mesh is fixed: the owned cells, their DoFs and their geometry
+        // are collected once, and the shape functions evaluated once on the
+        // reference cell.
+        geometry_cache.reinit(dof_handler, options.geometry_cache);
+        shapes.reinit(*fe, *quadrature);
     }
 
     pcout << "-----------------------------------------------" << std::endl;
@@ -77,13 +98,15 @@ void MonolithicNavierStokes<dim>::setup()
     // Initialize the linear system.
     {
 
+        // The PSPG term couples pressure to pressure: the (1,1) block is
+        // only allocated when the stabilization is active.
         Table<2, DoFTools::Coupling> coupling(dim + 1, dim + 1);
         for (unsigned int c = 0; c < dim + 1; ++c)
         {
             for (unsigned int d = 0; d < dim + 1; ++d)
             {
                 if (c == dim && d == dim)
-                    coupling[c][d] = DoFTools::none;
+                    coupling[c][d] = options.stabilization ? DoFTools::always : DoFTools::none;
                 else
                     coupling[c][d] = DoFTools::always;
             }
@@ -94,49 +117,203 @@ void MonolithicNavierStokes<dim>::setup()
         DoFTools::make_sparsity_pattern(dof_handler, coupling, sparsity);
         sparsity.compress();
 
-        for (unsigned int c = 0; c < dim + 1; ++c)
+        // The direct solver factorizes the whole system as a single matrix,
+        // whose pattern is the union of the ones of the blocks.
+        if (options.direct_solver != "none")
         {
-            for (unsigned int d = 0; d < dim + 1; ++d)
-            {
-                if (c == dim || d == dim)
-                    coupling[c][d] = DoFTools::none;
-                else
-                    coupling[c][d] = DoFTools::always;
-            }
+            TrilinosWrappers::SparsityPattern direct_sparsity(locally_owned_dofs, MPI_COMM_WORLD);
+            DoFTools::make_sparsity_pattern(dof_handler, coupling, direct_sparsity);
+            direct_sparsity.compress();
+
+            direct_matrix.reinit(direct_sparsity);
+            direct_rhs.reinit(locally_owned_dofs, MPI_COMM_WORLD);
+            direct_solution.reinit(locally_owned_dofs, MPI_COMM_WORLD);
+            direct_solver.set_solver(options.direct_solver);
         }
 
-        TrilinosWrappers::BlockSparsityPattern velocity_mass_sparsity(
-            block_owned_dofs, MPI_COMM_WORLD);
-        DoFTools::make_sparsity_pattern(dof_handler, coupling,
-                                        velocity_mass_sparsity);
-        velocity_mass_sparsity.compress();
-
-        TrilinosWrappers::BlockSparsityPattern pressure_mass_sparsity(
-            block_owned_dofs, MPI_COMM_WORLD);
-        if (true)
+        // The velocity operators share the pattern of the (0,0) block. The
+        // pressure operators use the (1,1) block when it is allocated, and
+        // otherwise a pattern with pressure-pressure couplings only.
+        TrilinosWrappers::BlockSparsityPattern pressure_sparsity;
+        if (!options.stabilization)
         {
             for (unsigned int c = 0; c < dim + 1; ++c)
-            {
                 for (unsigned int d = 0; d < dim + 1; ++d)
-                {
-                    if (c == dim && d == dim)
-                        coupling[c][d] = DoFTools::always;
-                    else
-                        coupling[c][d] = DoFTools::none;
-                }
-            }
+                    coupling[c][d] = (c == dim && d == dim) ? DoFTools::always : DoFTools::none;
 
-            DoFTools::make_sparsity_pattern(dof_handler, coupling,
-                                            pressure_mass_sparsity);
-            pressure_mass_sparsity.compress();
+            pressure_sparsity.reinit(block_owned_dofs, MPI_COMM_WORLD);
+            DoFTools::make_sparsity_pattern(dof_handler, coupling, pressure_sparsity);
+            pressure_sparsity.compress();
+        }
+        const TrilinosWrappers::SparsityPattern &pressure_block_sparsity =
+            options.stabilization ? sparsity.block(1, 1) : pressure_sparsity.block(1, 1);
+
+        stiffness_matrix.reinit(sparsity.block(0, 0));
+        velocity_mass.reinit(sparsity.block(0, 0));
+        pressure_mass.reinit(pressure_block_sparsity);
+
+        // Pressure operators of the PCD and Cahouet-Chabard preconditioners,
+        // with homogeneous Dirichlet conditions at the outflow (boundary 1),
+        // where the velocity satisfies a natural condition. The constraints
+        // use the numbering of the pressure block.
+        if (options.preconditioner == "pcd" || options.preconditioner == "cahouet-chabard")
+        {
+            ComponentMask pressure_mask(dim + 1, false);
+            pressure_mask.set(dim, true);
+
+            const types::global_dof_index n_u = block_owned_dofs[0].size();
+            const IndexSet outflow_dofs = DoFTools::extract_boundary_dofs(dof_handler, pressure_mask, {1});
+
+            pressure_outflow_constraints.clear();
+            pressure_outflow_constraints.reinit(block_relevant_dofs[1]);
+            for (const types::global_dof_index dof : outflow_dofs)
+                if (locally_relevant_dofs.is_element(dof))
+                    pressure_outflow_constraints.add_line(dof - n_u);
+            pressure_outflow_constraints.close();
+
+            pressure_laplace.reinit(pressure_block_sparsity);
+            if (options.preconditioner == "pcd")
+                pressure_convection_diffusion.reinit(pressure_block_sparsity);
         }
-        system_matrix.reinit(sparsity);
-        velocity_mass.reinit(velocity_mass_sparsity);
-        pressure_mass.reinit(pressure_mass_sparsity);
         lhs_matrix.reinit(sparsity);
         system_rhs.reinit(block_owned_dofs, MPI_COMM_WORLD);
         solution_owned.reinit(block_owned_dofs, MPI_COMM_WORLD);
         solution.reinit(block_owned_dofs, block_relevant_dofs, MPI_COMM_WORLD);
+        solution_old.reinit(block_owned_dofs, block_relevant_dofs, MPI_COMM_WORLD);
+
+        ghost_exchange.reinit(block_owned_dofs, block_relevant_dofs, MPI_COMM_WORLD);
+    }
+
+    // Prolongation of the velocity p-multigrid: interpolation of the P1
+    // velocity space on the same mesh into the velocity block. Each owned
+    // velocity DoF belongs to an owned cell, and its row does not depend on
+    // the cell it is computed from, so every owned row is set from the
+    // owned cells only.
+    if (options.velocity_multigrid)
+    {
+        AssertThrow(degree_velocity > 1,
+                    ExcMessage("velocity_multigrid requires a velocity degree of at least 2."));
+
+        const FESystem<dim> fe_coarse(FE_SimplexP<dim>(1), dim);
+        const FESystem<dim> fe_fine(FE_SimplexP<dim>(degree_velocity), dim);
+
+        dof_handler_coarse.reinit(mesh);
+        dof_handler_coarse.distribute_dofs(fe_coarse);
+
+        FullMatrix<double> interpolation(fe_fine.dofs_per_cell, fe_coarse.dofs_per_cell);
+        FETools::get_interpolation_matrix(fe_coarse, fe_fine, interpolation);
+
+        // Shape function of fe with the same component and scalar index as
+        // each shape function of fe_fine.
+        std::vector<unsigned int> fine_to_system(fe_fine.dofs_per_cell);
+        for (unsigned int k = 0; k < fe_fine.dofs_per_cell; ++k)
+            for (const unsigned int i : velocity_cell_dofs)
+                if (fe->system_to_component_index(i) == fe_fine.system_to_component_index(k))
+                    fine_to_system[k] = i;
+
+        std::vector<types::global_dof_index> dof_indices(fe->dofs_per_cell);
+        std::vector<types::global_dof_index> coarse_dof_indices(fe_coarse.dofs_per_cell);
+
+        // Call f(row, column, value) for every nonzero entry of the owned rows.
+        const auto for_each_entry = [&](const auto &f) {
+            auto coarse_cell = dof_handler_coarse.begin_active();
+            for (const auto &cell : dof_handler.active_cell_iterators())
+            {
+                if (cell->is_locally_owned())
+                {
+                    cell->get_dof_indices(dof_indices);
+                    coarse_cell->get_dof_indices(coarse_dof_indices);
+
+                    for (unsigned int k = 0; k < fe_fine.dofs_per_cell; ++k)
+                    {
+                        const types::global_dof_index row = dof_indices[fine_to_system[k]];
+                        if (!block_owned_dofs[0].is_element(row))
+                            continue;
+
+                        for (unsigned int j = 0; j < fe_coarse.dofs_per_cell; ++j)
+                            if (interpolation(k, j) != 0.0)
+                                f(row, coarse_dof_indices[j], interpolation(k, j));
+                    }
+                }
+                ++coarse_cell;
+            }
+        };
+
+        TrilinosWrappers::SparsityPattern prolongation_sparsity(block_owned_dofs[0],
+                                                                dof_handler_coarse.locally_owned_dofs(),
+                                                                MPI_COMM_WORLD);
+        for_each_entry([&](const types::global_dof_index row, const types::global_dof_index column, const double) {
+            prolongation_sparsity.add(row, column);
+        });
+        prolongation_sparsity.compress();
+
+        velocity_prolongation.reinit(prolongation_sparsity);
+        for_each_entry([&](const types::global_dof_index row, const types::global_dof_index column, const double value) {
+            velocity_prolongation.set(row, column, value);
+        });
+        velocity_prolongation.compress(VectorOperation::insert);
+
+        pcout << "  Number of coarse velocity DoFs = " << dof_handler_coarse.n_dofs() << std::endl;
+        pcout << "-----------------------------------------------" << std::endl;
+    }
+
+    // Dirichlet boundary conditions. The inlet profile does not depend on
+    // time, so the constrained DoFs and their values are computed once and
+    // imposed at every step by apply_dirichlet_conditions().
+    {
+        std::map<types::global_dof_index, double> boundary_values;
+        std::map<types::boundary_id, const Function<dim> *> boundary_functions;
+
+        ComponentMask mask;
+
+        static_assert(dim == 2 || dim == 3,
+                      "Dimensions other than 2 or 3 are not supported");
+
+        if constexpr (dim == 2)
+            mask = ComponentMask({true, true, false});
+        else if constexpr (dim == 3)
+            mask = ComponentMask({true, true, true, false});
+
+        boundary_functions[0] = &inlet_velocity;
+        VectorTools::interpolate_boundary_values(dof_handler,
+                                                 boundary_functions,
+                                                 boundary_values,
+                                                 mask);
+
+        boundary_functions.clear();
+        Functions::ZeroFunction<dim> zero_function(dim + 1);
+        boundary_functions[2] = &zero_function;
+        boundary_functions[3] = &zero_function;
+        VectorTools::interpolate_boundary_values(dof_handler,
+                                                 boundary_functions,
+                                                 boundary_values,
+                                                 mask);
+
+        dirichlet_dofs.clear();
+        dirichlet_values.clear();
+        for (const auto &boundary_value : boundary_values)
+        {
+            if (!locally_owned_dofs.is_element(boundary_value.first))
+                continue;
+
+            dirichlet_dofs.push_back(boundary_value.first);
+            dirichlet_values.push_back(boundary_value.second);
+        }
+    }
+
+    // Initialize the probes.
+    if (!options.probes_file.empty())
+    {
+        std::vector<std::string> names;
+        for (unsigned int d = 0; d < dim; ++d)
+            names.push_back("velocity_" + std::string(1, static_cast<char>('x' + d)));
+        names.push_back("pressure");
+
+        probes = std::make_unique<Probes<dim>>(options.probes_file);
+        probes->initialize({&dof_handler}, {names}, get_output_directory() + "probes.csv");
+
+        pcout << "  Number of probes = " << probes->n_probes() << std::endl;
+        pcout << "-----------------------------------------------" << std::endl;
     }
 }
 
@@ -145,22 +322,42 @@ void MonolithicNavierStokes<dim>::assemble_base_matrix()
 {
     const unsigned int dofs_per_cell = fe->dofs_per_cell;
     const unsigned int n_q = quadrature->size();
+    const unsigned int n_u_cell = velocity_cell_dofs.size();
+    const unsigned int n_p_cell = pressure_cell_dofs.size();
+    const types::global_dof_index n_u = block_owned_dofs[0].size();
 
     FEValues<dim> fe_values(*fe,
                             *quadrature,
                             update_values | update_gradients |
                                 update_quadrature_points | update_JxW_values);
 
-    FullMatrix<double> cell_system_matrix(dofs_per_cell, dofs_per_cell);
+    // Velocity-pressure coupling, in the numbering of the whole system.
+    FullMatrix<double> coupling_cell_matrix(dofs_per_cell, dofs_per_cell);
+
+    // Single-block operators, in the numbering of their block.
+    FullMatrix<double> stiffness_cell_matrix(n_u_cell, n_u_cell);
+    FullMatrix<double> velocity_mass_cell_matrix(n_u_cell, n_u_cell);
+    FullMatrix<double> pressure_mass_cell_matrix(n_p_cell, n_p_cell);
+    FullMatrix<double> pressure_laplace_cell_matrix(n_p_cell, n_p_cell);
 
     std::vector<types::global_dof_index> dof_indices(dofs_per_cell);
+    std::vector<types::global_dof_index> velocity_dof_indices(n_u_cell);
+    std::vector<types::global_dof_index> pressure_dof_indices(n_p_cell);
 
-    FullMatrix<double> velocity_mass_cell_matrix(dofs_per_cell, dofs_per_cell);
-    FullMatrix<double> pressure_mass_cell_matrix(dofs_per_cell, dofs_per_cell);
+    std::vector<double> div_phi_u(dofs_per_cell);
+    std::vector<Tensor<1, dim>> phi_u(dofs_per_cell);
+    std::vector<Tensor<2, dim>> grad_phi_u(dofs_per_cell);
+    std::vector<double> phi_p(dofs_per_cell);
+    std::vector<Tensor<1, dim>> grad_phi_p(dofs_per_cell);
 
+    const bool assemble_pressure_laplace = pressure_laplace.m() > 0;
+
+    lhs_matrix = 0.0;
+    stiffness_matrix = 0.0;
     velocity_mass = 0.0;
     pressure_mass = 0.0;
-    system_matrix = 0.0;
+    if (assemble_pressure_laplace)
+        pressure_laplace = 0.0;
 
     for (const auto &cell : dof_handler.active_cell_iterators())
     {
@@ -169,14 +366,11 @@ void MonolithicNavierStokes<dim>::assemble_base_matrix()
 
         fe_values.reinit(cell);
 
-        std::vector<double> div_phi_u(dofs_per_cell);
-        std::vector<Tensor<1, dim>> phi_u(dofs_per_cell);
-        std::vector<Tensor<2, dim>> grad_phi_u(dofs_per_cell);
-        std::vector<double> phi_p(dofs_per_cell);
-
-        pressure_mass_cell_matrix = 0.0;
+        coupling_cell_matrix = 0.0;
+        stiffness_cell_matrix = 0.0;
         velocity_mass_cell_matrix = 0.0;
-        cell_system_matrix = 0.0;
+        pressure_mass_cell_matrix = 0.0;
+        pressure_laplace_cell_matrix = 0.0;
 
         for (unsigned int q = 0; q < n_q; ++q)
         {
@@ -186,59 +380,102 @@ void MonolithicNavierStokes<dim>::assemble_base_matrix()
                 grad_phi_u[k] = fe_values[velocity].gradient(k, q);
                 phi_u[k] = fe_values[velocity].value(k, q);
                 phi_p[k] = fe_values[pressure].value(k, q);
+                grad_phi_p[k] = fe_values[pressure].gradient(k, q);
             }
 
-            for (unsigned int i = 0; i < dofs_per_cell; ++i)
+            // The mass component depends on the time scheme and is added to
+            // the momentum block in add_convective_term().
+            for (unsigned int i = 0; i < n_u_cell; ++i)
             {
-                for (unsigned int j = 0; j < dofs_per_cell; ++j)
+                const unsigned int ii = velocity_cell_dofs[i];
+
+                for (unsigned int j = 0; j < n_u_cell; ++j)
                 {
-                    // Mass Component
-                    // ------
-                    // M_ij = ∫ φ_i·φ_j dx
-                    // ------
-                    cell_system_matrix(i, j) += scalar_product(fe_values[velocity].value(i, q), fe_values[velocity].value(j, q)) / deltat * fe_values.JxW(q);
+                    const unsigned int jj = velocity_cell_dofs[j];
 
                     // Stiffness Component
                     // ------
                     // A_ij = ∫ ν ∇φ_i:∇φ_j dx
                     // ------
-                    cell_system_matrix(i, j) += nu * scalar_product(fe_values[velocity].gradient(i, q), fe_values[velocity].gradient(j, q)) * fe_values.JxW(q);
+                    stiffness_cell_matrix(i, j) += nu * scalar_product(grad_phi_u[ii], grad_phi_u[jj]) * fe_values.JxW(q);
+
+                    // Grad-div stabilization
+                    // ------
+                    // G_ij = γ ∫ (∇·φ_j)(∇·φ_i) dx
+                    // ------
+                    if (options.grad_div > 0.0)
+                        stiffness_cell_matrix(i, j) += options.grad_div * div_phi_u[jj] * div_phi_u[ii] * fe_values.JxW(q);
+
+                    // Mass matrix for the velocity
+                    // ------
+                    // Mv_ij = ∫ (1/Δt) φ_i·φ_j dx
+                    // ------
+                    velocity_mass_cell_matrix(i, j) += scalar_product(phi_u[ii], phi_u[jj]) / deltat * fe_values.JxW(q);
+                }
+
+                for (unsigned int j = 0; j < n_p_cell; ++j)
+                {
+                    const unsigned int jj = pressure_cell_dofs[j];
 
                     // Pressure term in the momentum equation
                     // ------
                     // B_ij = -∫ ψ_j ∇·φ_i dx
                     // ------
-                    cell_system_matrix(i, j) -= fe_values[pressure].value(j, q) * fe_values[velocity].divergence(i, q) * fe_values.JxW(q);
+                    coupling_cell_matrix(ii, jj) -= phi_p[jj] * div_phi_u[ii] * fe_values.JxW(q);
 
                     // Pressure term in the continuity equation
                     // ------
-                    // B_ij^T = ∫ ψ_i ∇·φ_j dx
+                    // B_ji^T = ∫ ψ_j ∇·φ_i dx
                     // ------
-                    cell_system_matrix(i, j) += fe_values[pressure].value(i, q) * fe_values[velocity].divergence(j, q) * fe_values.JxW(q);
+                    coupling_cell_matrix(jj, ii) += phi_p[jj] * div_phi_u[ii] * fe_values.JxW(q);
+                }
+            }
+
+            for (unsigned int i = 0; i < n_p_cell; ++i)
+            {
+                const unsigned int ii = pressure_cell_dofs[i];
+
+                for (unsigned int j = 0; j < n_p_cell; ++j)
+                {
+                    const unsigned int jj = pressure_cell_dofs[j];
 
                     // Mass matrix for the pressure
                     // ------
                     // Mp_ij = ∫ (1/ν)ψ_i ψ_j dx
                     // ------
-                    pressure_mass_cell_matrix(i, j) += fe_values[pressure].value(j, q) * fe_values[pressure].value(i, q) / nu * fe_values.JxW(q);
+                    pressure_mass_cell_matrix(i, j) += phi_p[jj] * phi_p[ii] / nu * fe_values.JxW(q);
 
-                    // Mass matrix for the velocity
+                    // Laplacian for the pressure (PCD and Cahouet-Chabard)
                     // ------
-                    // Mv_ij = ∫ (1/Δt) φ_i·φ_j dx
+                    // Ap_ij = ∫ ∇ψ_i·∇ψ_j dx
                     // ------
-                    velocity_mass_cell_matrix(i, j) += scalar_product(fe_values[velocity].value(i, q), fe_values[velocity].value(j, q)) / deltat * fe_values.JxW(q);
+                    if (assemble_pressure_laplace)
+                        pressure_laplace_cell_matrix(i, j) += grad_phi_p[ii] * grad_phi_p[jj] * fe_values.JxW(q);
                 }
             }
         }
-        cell->get_dof_indices(dof_indices);
 
-        system_matrix.add(dof_indices, cell_system_matrix);
-        velocity_mass.add(dof_indices, velocity_mass_cell_matrix);
-        pressure_mass.add(dof_indices, pressure_mass_cell_matrix);
+        cell->get_dof_indices(dof_indices);
+        for (unsigned int i = 0; i < n_u_cell; ++i)
+            velocity_dof_indices[i] = dof_indices[velocity_cell_dofs[i]];
+        for (unsigned int i = 0; i < n_p_cell; ++i)
+            pressure_dof_indices[i] = dof_indices[pressure_cell_dofs[i]] - n_u;
+
+        lhs_matrix.add(dof_indices, coupling_cell_matrix);
+        stiffness_matrix.add(velocity_dof_indices, stiffness_cell_matrix);
+        velocity_mass.add(velocity_dof_indices, velocity_mass_cell_matrix);
+        pressure_mass.add(pressure_dof_indices, pressure_mass_cell_matrix);
+        if (assemble_pressure_laplace)
+            pressure_outflow_constraints.distribute_local_to_global(pressure_laplace_cell_matrix,
+                                                                    pressure_dof_indices,
+                                                                    pressure_laplace);
     }
-    system_matrix.compress(VectorOperation::add);
-    pressure_mass.compress(VectorOperation::add);
+    lhs_matrix.compress(VectorOperation::add);
+    stiffness_matrix.compress(VectorOperation::add);
     velocity_mass.compress(VectorOperation::add);
+    pressure_mass.compress(VectorOperation::add);
+    if (assemble_pressure_laplace)
+        pressure_laplace.compress(VectorOperation::add);
 }
 
 template <unsigned int dim>
@@ -247,60 +484,232 @@ void MonolithicNavierStokes<dim>::add_convective_term()
     const unsigned int dofs_per_cell = fe->dofs_per_cell;
     const unsigned int n_q = quadrature->size();
 
-    FEValues<dim> fe_values(*fe,
-                            *quadrature,
-                            update_values | update_gradients |
-                                update_quadrature_points | update_JxW_values);
+    const unsigned int n_p_cell = pressure_cell_dofs.size();
+    const types::global_dof_index n_u = block_owned_dofs[0].size();
 
-    FullMatrix<double> cell_lhs_matrix(dofs_per_cell, dofs_per_cell);
+    FullMatrix<double> pressure_convection_diffusion_cell_matrix(n_p_cell, n_p_cell);
 
-    std::vector<types::global_dof_index> dof_indices(dofs_per_cell);
+    std::vector<types::global_dof_index> pressure_dof_indices(n_p_cell);
+
+    std::vector<double> local_solution(dofs_per_cell);
+    std::vector<double> local_solution_old(dofs_per_cell);
 
     std::vector<Tensor<1, dim>> previous_velocity_values(n_q);
     std::vector<double> previous_velocity_divergence(n_q);
+    std::vector<Tensor<1, dim>> old_velocity_values(n_q);
+    std::vector<double> old_velocity_divergence(n_q);
+
+    const double alpha_0 = (bdf_order == 2) ? 1.5 : 1.0;
+
+    const bool assemble_pcd = pressure_convection_diffusion.m() > 0;
+
+    // Shape function gradients on the current cell.
+    std::vector<Tensor<1, dim>> shape_gradients(dofs_per_cell);
+
+    // SUPG/PSPG residual and test functions of each shape function.
+    std::vector<Tensor<1, dim>> stabilization_residual(dofs_per_cell);
+    std::vector<Tensor<1, dim>> stabilization_test(dofs_per_cell);
+    std::vector<double> div_phi_u(dofs_per_cell);
+    std::vector<double> phi_p(dofs_per_cell);
+
+    const auto start = std::chrono::steady_clock::now();
+
+    // The convective and skew-symmetric terms are computed for batches of
+    // cells at once, vectorized across the cells of the batch. The other
+    // terms of each cell are accumulated in the cell matrix of its lane.
+    //
+    // Non-linear term
+    // ------
+    // N_ij(u*) = ∫ (u*·∇u)·φ_j dx
+    // ------
+    // skew-symmetric term
+    // ------
+    // S_ij = (1/2) ∫ ∇·u* φ_i·φ_j dx
+    // ------
+    ConvectionBatch<dim> batch(*fe, n_q, 0, 0.0, 0.0, 0.5);
+
+    std::vector<FullMatrix<double>> batch_cell_matrices(batch.n_lanes,
+                                                        FullMatrix<double>(dofs_per_cell, dofs_per_cell));
+    std::vector<const std::vector<types::global_dof_index> *> batch_dof_indices(batch.n_lanes);
+
+    const auto flush_batch = [&]() {
+        batch.compute();
+        for (unsigned int lane = 0; lane < batch.size(); ++lane)
+        {
+            batch.distribute(lane, batch_cell_matrices[lane]);
+            lhs_matrix.add(*batch_dof_indices[lane], batch_cell_matrices[lane]);
+        }
+        batch.clear();
+    };
+
+    // The pressure blocks of the lhs matrix are time independent and are
+    // kept from assemble_base_matrix(); only the momentum block is rebuilt.
+    lhs_matrix.block(0, 0).copy_from(stiffness_matrix);
+
+    // Mass Component
+    // ------
+    // M_ij = (α_0/Δt) ∫ φ_i·φ_j dx,  α_0 = 1 (BDF1), 3/2 (BDF2)
+    // ------
+    lhs_matrix.block(0, 0).add(alpha_0, velocity_mass);
+
+    // The stabilization terms depend on u*: the pressure blocks are then
+    // rebuilt from scratch together with them.
+    if (options.stabilization)
+    {
+        lhs_matrix.block(0, 1) = 0.0;
+        lhs_matrix.block(1, 0) = 0.0;
+        lhs_matrix.block(1, 1) = 0.0;
+    }
 
-    lhs_matrix = 0.0;
-
-    lhs_matrix.copy_from(system_matrix);
+    if (assemble_pcd)
+        pressure_convection_diffusion = 0.0;
 
-    for (const auto &cell : dof_handler.active_cell_iterators())
+    for (unsigned int c = 0; c < geometry_cache.size(); ++c)
     {
-        if (!cell->is_locally_owned())
-            continue;
+        // The interior cells only read owned entries of the solution: the
+        // ghost entries are needed from the first partition-boundary cell.
+        if (c == geometry_cache.n_interior_cells())
+            ghost_exchange.finish();
 
-        fe_values.reinit(cell);
+        const CellGeometry<dim> geometry = geometry_cache.geometry(c);
+        const std::vector<types::global_dof_index> &dof_indices = geometry_cache.cell_dof_indices(c);
+
+        const unsigned int lane = batch.size();
+        FullMatrix<double> &cell_lhs_matrix = batch_cell_matrices[lane];
+        batch_dof_indices[lane] = &dof_indices;
 
         cell_lhs_matrix = 0.0;
 
-        fe_values[velocity].get_function_values(solution, previous_velocity_values);
-        fe_values[velocity].get_function_divergences(solution, previous_velocity_divergence);
+        solution.extract_subvector_to(dof_indices.begin(), dof_indices.end(), local_solution.begin());
+        shapes.vector_values(local_solution, previous_velocity_values);
+        shapes.divergences(local_solution, geometry.inverse_jacobian, previous_velocity_divergence);
 
-        for (unsigned int q = 0; q < n_q; ++q)
+        // ------
+        // u* = u^n (BDF1), u* = 2u^n - u^{n-1} (BDF2)
+        // ------
+        if (bdf_order == 2)
         {
-            for (unsigned int i = 0; i < dofs_per_cell; ++i)
+            solution_old.extract_subvector_to(dof_indices.begin(), dof_indices.end(), local_solution_old.begin());
+            shapes.vector_values(local_solution_old, old_velocity_values);
+            shapes.divergences(local_solution_old, geometry.inverse_jacobian, old_velocity_divergence);
+
+            for (unsigned int q = 0; q < n_q; ++q)
+            {
+                previous_velocity_values[q] = 2.0 * previous_velocity_values[q] - old_velocity_values[q];
+                previous_velocity_divergence[q] = 2.0 * previous_velocity_divergence[q] - old_velocity_divergence[q];
+            }
+        }
+
+        batch.add_cell(shapes, geometry.inverse_jacobian, geometry.jacobian_determinant,
+                       previous_velocity_values, previous_velocity_divergence);
+
+        // SUPG/PSPG stabilization
+        // ------
+        // R(u, p) = (α_0/Δt) u + (u*·∇)u + ∇p
+        // K_ij = Σ_q τ R(φ_j, ψ_j)·((u*·∇)φ_i + ∇ψ_i) JxW
+        // ------
+        if (options.stabilization)
+        {
+            const double h = geometry.diameter / degree_velocity;
+
+            for (unsigned int q = 0; q < n_q; ++q)
             {
-                for (unsigned int j = 0; j < dofs_per_cell; ++j)
+                const double JxW = shapes.weight(q) * geometry.jacobian_determinant;
+
+                const double tau = compute_stabilization_parameter(
+                    h, previous_velocity_values[q].norm(), nu, alpha_0 / deltat);
+
+                // Shape function k is nonzero only in its component: a
+                // velocity component (φ_k = ϕ_k e_c) or the pressure (ψ_k = ϕ_k).
+                for (unsigned int k = 0; k < dofs_per_cell; ++k)
                 {
-                    // Non-linear term
-                    // ------
-                    // N_ij(u*) = ∫ (u*·∇u)·φ_j dx
-                    // ------
-                    cell_lhs_matrix(i, j) += scalar_product(fe_values[velocity].gradient(j, q) * previous_velocity_values[q], fe_values[velocity].value(i, q)) * fe_values.JxW(q);
+                    const unsigned int component = shapes.component(k);
+                    const Tensor<1, dim> gradient = shapes.gradient(k, q, geometry.inverse_jacobian);
 
-                    // skew-symmetric term
-                    // ------
-                    // S_ij = (1/2) ∫ ∇·u* φ_i·φ_j dx
-                    // ------
-                    cell_lhs_matrix(i, j) += 0.5 * previous_velocity_divergence[q] * scalar_product(fe_values[velocity].value(i, q), fe_values[velocity].value(j, q)) * fe_values.JxW(q);
+                    stabilization_test[k] = 0.0;
+                    stabilization_residual[k] = 0.0;
+                    if (component < dim)
+                    {
+                        stabilization_test[k][component] = gradient * previous_velocity_values[q];
+                        stabilization_residual[k][component] = alpha_0 / deltat * shapes.value(k, q);
+                        div_phi_u[k] = gradient[component];
+                        phi_p[k] = 0.0;
+                    }
+                    else
+                    {
+                        stabilization_test[k] = gradient;
+                        div_phi_u[k] = 0.0;
+                        phi_p[k] = shapes.value(k, q);
+                    }
+                    stabilization_residual[k] += stabilization_test[k];
                 }
+
+                // The SUPG/PSPG terms plus the pressure terms B and -B^T
+                for (unsigned int i = 0; i < dofs_per_cell; ++i)
+                    for (unsigned int j = 0; j < dofs_per_cell; ++j)
+                        cell_lhs_matrix(i, j) += (tau * stabilization_residual[j] * stabilization_test[i] -
+                                                  phi_p[j] * div_phi_u[i] +
+                                                  phi_p[i] * div_phi_u[j]) *
+                                                 JxW;
             }
         }
 
-        cell->get_dof_indices(dof_indices);
+        // Pressure convection-diffusion operator (PCD preconditioner)
+        // ------
+        // Fp_ij = ∫ (α_0/Δt) ψ_i ψ_j + ν ∇ψ_i·∇ψ_j + (u*·∇ψ_j) ψ_i dx
+        // ------
+        if (assemble_pcd)
+        {
+            pressure_convection_diffusion_cell_matrix = 0.0;
+
+            for (unsigned int q = 0; q < n_q; ++q)
+            {
+                const double JxW = shapes.weight(q) * geometry.jacobian_determinant;
+
+                for (unsigned int i = 0; i < n_p_cell; ++i)
+                    shape_gradients[i] = shapes.gradient(pressure_cell_dofs[i], q, geometry.inverse_jacobian);
+
+                for (unsigned int i = 0; i < n_p_cell; ++i)
+                {
+                    const unsigned int ii = pressure_cell_dofs[i];
+
+                    for (unsigned int j = 0; j < n_p_cell; ++j)
+                    {
+                        const unsigned int jj = pressure_cell_dofs[j];
 
-        lhs_matrix.add(dof_indices, cell_lhs_matrix);
+                        pressure_convection_diffusion_cell_matrix(i, j) +=
+                            (alpha_0 / deltat * shapes.value(ii, q) * shapes.value(jj, q) +
+                             nu * shape_gradients[i] * shape_gradients[j] +
+                             previous_velocity_values[q] * shape_gradients[j] * shapes.value(ii, q)) *
+                            JxW;
+                    }
+                }
+            }
+
+            for (unsigned int i = 0; i < n_p_cell; ++i)
+                pressure_dof_indices[i] = dof_indices[pressure_cell_dofs[i]] - n_u;
+
+            pressure_outflow_constraints.distribute_local_to_global(pressure_convection_diffusion_cell_matrix,
+                                                                    pressure_dof_indices,
+                                                                    pressure_convection_diffusion);
+        }
+
+        if (batch.full())
+            flush_batch();
     }
+    if (batch.size() > 0)
+        flush_batch();
+
+    // Without partition-boundary cells the exchange is completed here.
+    ghost_exchange.finish();
+
     lhs_matrix.compress(VectorOperation::add);
+
+    if (assemble_pcd)
+        pressure_convection_diffusion.compress(VectorOperation::add);
+
+    convective_assembly_time += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    n_convective_cells += geometry_cache.size();
 }
 
 template <unsigned int dim>
@@ -310,11 +719,6 @@ void MonolithicNavierStokes<dim>::assemble_rhs()
     const unsigned int n_q = quadrature->size();
     const unsigned int n_q_face = quadrature_face->size();
 
-    FEValues<dim> fe_values(*fe,
-                            *quadrature,
-                            update_values | update_gradients | update_quadrature_points |
-                                update_JxW_values);
-
     FEFaceValues<dim> fe_face_values(*fe,
                                      *quadrature_face,
                                      update_values |
@@ -322,52 +726,122 @@ void MonolithicNavierStokes<dim>::assemble_rhs()
                                          update_JxW_values);
     Vector<double> cell_rhs(dofs_per_cell);
 
+    std::vector<double> local_solution(dofs_per_cell);
+
     std::vector<Tensor<1, dim>> previous_velocity_values(n_q);
 
-    std::vector<types::global_dof_index> dof_indices(dofs_per_cell);
+    std::vector<Tensor<1, dim>> old_velocity_values(n_q);
+
+    std::vector<Tensor<1, dim>> advection_velocity_values(n_q);
 
     Vector<double> f_neumann_loc(dim + 1);
 
+    Vector<double> f_new_loc(dim);
+
+    const double alpha_0 = (bdf_order == 2) ? 1.5 : 1.0;
+
     Tensor<1, dim> f_neumann_tensor;
 
     system_rhs = 0.0;
 
-    for (const auto &cell : dof_handler.active_cell_iterators())
+    forcing_term.set_time(time);
+
+    for (unsigned int c = 0; c < geometry_cache.size(); ++c)
     {
-        if (!cell->is_locally_owned())
-            continue;
+        if (c == geometry_cache.n_interior_cells())
+            ghost_exchange.finish();
 
-        fe_values.reinit(cell);
+        const auto &cell = geometry_cache.cell(c);
+        const CellGeometry<dim> geometry = geometry_cache.geometry(c);
+        const std::vector<types::global_dof_index> &dof_indices = geometry_cache.cell_dof_indices(c);
+
+        solution.extract_subvector_to(dof_indices.begin(), dof_indices.end(), local_solution.begin());
+        shapes.vector_values(local_solution, previous_velocity_values);
+
+        // Advection velocity u* of the stabilization terms (see add_convective_term()).
+        if (options.stabilization)
+            advection_velocity_values = previous_velocity_values;
+
+        // ------
+        // BDF2: (1/2)(4u^n - u^{n-1}) replaces u^n in the time derivative
+        // ------
+        if (bdf_order == 2)
+        {
+            solution_old.extract_subvector_to(dof_indices.begin(), dof_indices.end(), local_solution.begin());
+            shapes.vector_values(local_solution, old_velocity_values);
+
+            for (unsigned int q = 0; q < n_q; ++q)
+            {
+                if (options.stabilization)
+                    advection_velocity_values[q] = 2.0 * previous_velocity_values[q] - old_velocity_values[q];
+                previous_velocity_values[q] = 2.0 * previous_velocity_values[q] - 0.5 * old_velocity_values[q];
+            }
+        }
 
-        fe_values[velocity].get_function_values(solution, previous_velocity_values);
+        const double h = geometry.diameter / degree_velocity;
 
         cell_rhs = 0.0;
 
         for (unsigned int q = 0; q < n_q; ++q)
         {
+            const double JxW = shapes.weight(q) * geometry.jacobian_determinant;
+
             // Compute f(tn+1)
-            Vector<double> f_new_loc(dim);
-            forcing_term.set_time(time);
-            forcing_term.vector_value(fe_values.quadrature_point(q),
-                                      f_new_loc);
             Tensor<1, dim> forcing_term_new_tensor;
-            for (unsigned int d = 0; d < dim; ++d)
-                forcing_term_new_tensor[d] = f_new_loc[d];
+            if (!zero_forcing)
+            {
+                forcing_term.vector_value(geometry.quadrature_point(shapes.point(q)),
+                                          f_new_loc);
+                for (unsigned int d = 0; d < dim; ++d)
+                    forcing_term_new_tensor[d] = f_new_loc[d];
+            }
 
+            // φ_i = ϕ_i e_c is nonzero only in its component c: the
+            // velocity terms only involve the velocity shape functions.
             for (unsigned int i = 0; i < dofs_per_cell; ++i)
             {
+                const unsigned int component = shapes.component(i);
+                if (component >= dim)
+                    continue;
+
                 // Time dependent term
                 // ------
-                // ∫ (1/Δt)(u*·φ_i) dx
+                // ∫ (1/Δt)(u^n·φ_i) dx                       (BDF1)
+                // ∫ (1/2Δt)(4u^n·φ_i - u^{n-1}·φ_i) dx       (BDF2)
                 // ------
-                cell_rhs(i) += scalar_product(previous_velocity_values[q], fe_values[velocity].value(i, q)) * fe_values.JxW(q) / deltat;
+                cell_rhs(i) += previous_velocity_values[q][component] * shapes.value(i, q) * JxW / deltat;
 
                 // Forcing Term
                 // ------
                 // ∫ f(t+1)·φ_i dx
                 // ------
                 if (!zero_forcing)
-                    cell_rhs(i) += scalar_product(forcing_term_new_tensor, fe_values[velocity].value(i, q)) * fe_values.JxW(q);
+                    cell_rhs(i) += forcing_term_new_tensor[component] * shapes.value(i, q) * JxW;
+            }
+
+            // SUPG/PSPG stabilization: known part of the residual
+            // ------
+            // Σ_q τ (u^n/Δt + f)·((u*·∇)φ_i + ∇ψ_i) JxW     (u^n as in the time dependent term)
+            // ------
+            if (options.stabilization)
+            {
+                const double tau = compute_stabilization_parameter(
+                    h, advection_velocity_values[q].norm(), nu, alpha_0 / deltat);
+
+                Tensor<1, dim> known_residual = previous_velocity_values[q] / deltat;
+                if (!zero_forcing)
+                    known_residual += forcing_term_new_tensor;
+
+                for (unsigned int i = 0; i < dofs_per_cell; ++i)
+                {
+                    const unsigned int component = shapes.component(i);
+                    const Tensor<1, dim> gradient = shapes.gradient(i, q, geometry.inverse_jacobian);
+
+                    const double test = (component < dim)
+                                            ? known_residual[component] * (gradient * advection_velocity_values[q])
+                                            : known_residual * gradient;
+                    cell_rhs(i) += tau * test * JxW;
+                }
             }
         }
 
@@ -402,73 +876,156 @@ void MonolithicNavierStokes<dim>::assemble_rhs()
                 }
             }
         }
-        cell->get_dof_indices(dof_indices);
         system_rhs.add(dof_indices, cell_rhs);
     }
 
     system_rhs.compress(VectorOperation::add);
 
     // We apply boundary conditions to the algebraic system.
+    apply_dirichlet_conditions();
+}
+
+template <unsigned int dim>
+void MonolithicNavierStokes<dim>::apply_dirichlet_conditions()
+{
+    // The Dirichlet rows of the momentum block are reset at every step by
+    // add_convective_term(). Each one is replaced by its own diagonal
+    // entry, which keeps the scaling of the row, and the coupling row by
+    // zero. Only owned rows are touched, so no communication is needed
+    // besides the final compress. The velocity DoFs come first, so their
+    // global index is also their index in block 0.
+    TrilinosWrappers::SparseMatrix &momentum_matrix = lhs_matrix.block(0, 0);
+
+    for (unsigned int k = 0; k < dirichlet_dofs.size(); ++k)
     {
-        std::map<types::global_dof_index, double> boundary_values;
-        std::map<types::boundary_id, const Function<dim> *> boundary_functions;
+        const types::global_dof_index dof = dirichlet_dofs[k];
+        const double diagonal = momentum_matrix.diag_element(dof);
 
-        ComponentMask mask;
+        momentum_matrix.clear_row(dof, diagonal);
+        system_rhs.block(0)(dof) = diagonal * dirichlet_values[k];
+        solution_owned.block(0)(dof) = dirichlet_values[k];
+    }
+    lhs_matrix.block(0, 1).clear_rows(dirichlet_dofs);
 
-        static_assert(dim == 2 || dim == 3,
-                      "Dimensions other than 2 or 3 are not supported");
+    system_rhs.compress(VectorOperation::insert);
+    solution_owned.compress(VectorOperation::insert);
+}
 
-        if constexpr (dim == 2)
-            mask = ComponentMask({true, true, false});
-        else if constexpr (dim == 3)
-            mask = ComponentMask({true, true, true, false});
+template <unsigned int dim>
+template <typename PreconditionerType>
+PreconditionerType &MonolithicNavierStokes<dim>::get_block_preconditioner()
+{
+    if (!block_precondition)
+    {
+        block_precondition = std::make_shared<PreconditionerType>();
+        block_precondition->set_inner_cycles(options.inner_cycles);
+        block_precondition->set_mixed_precision(options.mixed_precision);
+        block_precondition->set_variable_coupling(options.stabilization);
+        if (options.velocity_multigrid)
+            block_precondition->set_velocity_multigrid(velocity_prolongation);
+    }
 
-        boundary_functions[0] = &inlet_velocity;
-        VectorTools::interpolate_boundary_values(dof_handler,
-                                                 boundary_functions,
-                                                 boundary_values,
-                                                 mask);
+    return static_cast<PreconditionerType &>(*block_precondition);
+}
 
-        boundary_functions.clear();
-        Functions::ZeroFunction<dim> zero_function(dim + 1);
-        boundary_functions[2] = &zero_function;
-        boundary_functions[3] = &zero_function;
-        VectorTools::interpolate_boundary_values(dof_handler,
-                                                 boundary_functions,
-                                                 boundary_values,
-                                                 mask);
+template <unsigned int dim>
+void MonolithicNavierStokes<dim>::solve_direct()
+{
+    const types::global_dof_index n_u = block_owned_dofs[0].size();
+
+    // Global index of the local entry index of map.
+    const auto global_index = [](const Epetra_Map &map, const int index) -> types::global_dof_index {
+#ifdef DEAL_II_WITH_64BIT_INDICES
+        return map.GID64(index);
+#else
+        return map.GID(index);
+#endif
+    };
+
+    // Copy the blocks into the single matrix. All their entries are in its
+    // pattern, so the values are replaced in place.
+    std::vector<types::global_dof_index> columns;
+    for (unsigned int i = 0; i < 2; ++i)
+    {
+        for (unsigned int j = 0; j < 2; ++j)
+        {
+            const Epetra_CrsMatrix &block = lhs_matrix.block(i, j).trilinos_matrix();
+
+            for (int r = 0; r < block.NumMyRows(); ++r)
+            {
+                int n_entries;
+                double *row_values;
+                int *row_indices;
+                block.ExtractMyRowView(r, n_entries, row_values, row_indices);
 
-        MatrixTools::apply_boundary_values(
-            boundary_values, lhs_matrix, solution_owned, system_rhs, false);
+                columns.resize(n_entries);
+                for (int e = 0; e < n_entries; ++e)
+                    columns[e] = global_index(block.ColMap(), row_indices[e]) + j * n_u;
+
+                direct_matrix.set(global_index(block.RowMap(), r) + i * n_u, n_entries, columns.data(), row_values);
+            }
+        }
     }
+    direct_matrix.compress(VectorOperation::insert);
+
+    // The owned DoFs of the velocity block come before the ones of the
+    // pressure block, in the local storage of the single vectors as well.
+    const std::size_t n_u_owned = system_rhs.block(0).end() - system_rhs.block(0).begin();
+
+    std::copy(system_rhs.block(0).begin(), system_rhs.block(0).end(), direct_rhs.begin());
+    std::copy(system_rhs.block(1).begin(), system_rhs.block(1).end(), direct_rhs.begin() + n_u_owned);
+
+    // The pattern is the same at every step: only the first factorization
+    // runs the symbolic analysis.
+    direct_solver.factorize(direct_matrix);
+    direct_solver.solve(direct_solution, direct_rhs);
+
+    std::copy(direct_solution.begin(), direct_solution.begin() + n_u_owned, solution_owned.block(0).begin());
+    std::copy(direct_solution.begin() + n_u_owned, direct_solution.end(), solution_owned.block(1).begin());
+
+    pcout << "  Direct solve (" << options.direct_solver << ")" << std::endl;
 }
 
 template <unsigned int dim>
 void MonolithicNavierStokes<dim>::solve_time_step()
 {
-    // Choose the preconditioner type:
-    // 1 = SIMPLE, 2 = ASIMPLE, 3 = YOSIDA, 4 = AYOSIDA.
-    static constexpr int precond_type = 1; // Set this value as needed
+    if (options.direct_solver != "none")
+    {
+        solve_direct();
+
+        solution_old = solution;
+        ghost_exchange.start(solution_owned, solution);
+        return;
+    }
+
+    // Choose the preconditioner type (option "preconditioner"):
+    // 1 = SIMPLE, 2 = ASIMPLE, 3 = YOSIDA, 4 = PCD, 5 = LSC, 6 = CAHOUET-CHABARD,
+    // 7 = AUGMENTED-LAGRANGIAN.
+    static const std::map<std::string, int> precond_types = {
+        {"simple", 1}, {"asimple", 2}, {"yosida", 3}, {"pcd", 4}, {"lsc", 5}, {"cahouet-chabard", 6},
+        {"augmented-lagrangian", 7}};
+    AssertThrow(precond_types.count(options.preconditioner) > 0,
+                ExcMessage("Unknown preconditioner '" + options.preconditioner + "'"));
+    const int precond_type = precond_types.at(options.preconditioner);
 
     // Local parameters for inner solvers and preconditioner initialization.
     static constexpr double alpha = 1;                   // Damping parameter for SIMPLE-like preconditioners
     static constexpr unsigned int maxiter_inner = 10000; // Maximum iterations for inner solvers
-    static constexpr double tol_inner = 1e-5;            // Tolerance for inner solvers
+    const double tol_inner = options.inner_tolerance;    // Tolerance for inner solvers
     static constexpr bool use_ilu = false;               // Flag: true for ILU, false for AMG
 
-    // Set up the outer GMRES solver.
     SolverControl solver_control(10000, 1e-7);
-    SolverGMRES<TrilinosWrappers::MPI::BlockVector> solver(solver_control);
-
-    std::shared_ptr<BlockPrecondition> block_precondition;
 
-    // Select and initialize the preconditioner based on precond_type.
+    // Select and initialize the preconditioner based on precond_type. The
+    // preconditioner is created at the first time step and kept afterwards,
+    // so that the data that does not change between steps (Yosida's S and
+    // the LSC matrix without stabilization) is computed only once.
     switch (precond_type)
     {
     case 1:
     {
-        auto simple_precondition = std::make_shared<PreconditionSIMPLE>();
-        simple_precondition->initialize(
+        PreconditionSIMPLE &simple_precondition = get_block_preconditioner<PreconditionSIMPLE>();
+        simple_precondition.initialize(
             lhs_matrix.block(0, 0),
             lhs_matrix.block(1, 0),
             lhs_matrix.block(0, 1),
@@ -477,13 +1034,12 @@ void MonolithicNavierStokes<dim>::solve_time_step()
             maxiter_inner,
             tol_inner,
             use_ilu);
-        block_precondition = simple_precondition;
         break;
     }
     case 2:
     {
-        auto asimple_precondition = std::make_shared<PreconditionaSIMPLE>();
-        asimple_precondition->initialize(
+        PreconditionaSIMPLE &asimple_precondition = get_block_preconditioner<PreconditionaSIMPLE>();
+        asimple_precondition.initialize(
             lhs_matrix.block(0, 0),
             lhs_matrix.block(1, 0),
             lhs_matrix.block(0, 1),
@@ -492,38 +1048,133 @@ void MonolithicNavierStokes<dim>::solve_time_step()
             maxiter_inner,
             tol_inner,
             use_ilu);
-        block_precondition = asimple_precondition;
         break;
     }
     case 3:
     {
-        auto yosida_precondition = std::make_shared<PreconditionYosida>();
-        yosida_precondition->initialize(
+        PreconditionYosida &yosida_precondition = get_block_preconditioner<PreconditionYosida>();
+        yosida_precondition.initialize(
+            lhs_matrix.block(0, 0),
+            lhs_matrix.block(1, 0),
+            lhs_matrix.block(0, 1),
+            velocity_mass,
+            solution_owned,
+            maxiter_inner,
+            tol_inner,
+            use_ilu);
+        break;
+    }
+    case 4:
+    {
+        PreconditionPCD &pcd_precondition = get_block_preconditioner<PreconditionPCD>();
+        pcd_precondition.initialize(
+            lhs_matrix.block(0, 0),
+            lhs_matrix.block(1, 0),
+            lhs_matrix.block(0, 1),
+            pressure_mass,
+            pressure_laplace,
+            pressure_convection_diffusion,
+            nu,
+            maxiter_inner,
+            tol_inner,
+            use_ilu);
+        break;
+    }
+    case 5:
+    {
+        PreconditionLSC &lsc_precondition = get_block_preconditioner<PreconditionLSC>();
+        lsc_precondition.initialize(
             lhs_matrix.block(0, 0),
             lhs_matrix.block(1, 0),
             lhs_matrix.block(0, 1),
-            velocity_mass.block(0, 0),
+            velocity_mass,
             solution_owned,
             maxiter_inner,
             tol_inner,
             use_ilu);
-        block_precondition = yosida_precondition;
+        break;
+    }
+    case 6:
+    {
+        PreconditionCahouetChabard &cc_precondition = get_block_preconditioner<PreconditionCahouetChabard>();
+        cc_precondition.initialize(
+            lhs_matrix.block(0, 0),
+            lhs_matrix.block(1, 0),
+            lhs_matrix.block(0, 1),
+            pressure_mass,
+            pressure_laplace,
+            ((bdf_order == 2) ? 1.5 : 1.0) / deltat,
+            maxiter_inner,
+            tol_inner,
+            use_ilu);
+        break;
+    }
+    case 7:
+    {
+        PreconditionAugmentedLagrangian &al_precondition = get_block_preconditioner<PreconditionAugmentedLagrangian>();
+        al_precondition.initialize(
+            lhs_matrix.block(0, 0),
+            lhs_matrix.block(1, 0),
+            lhs_matrix.block(0, 1),
+            pressure_mass,
+            nu,
+            options.grad_div,
+            maxiter_inner,
+            tol_inner,
+            use_ilu);
         break;
     }
     default:
         Assert(false, ExcNotImplemented());
     }
 
-    solver.solve(lhs_matrix,
-                 solution_owned,
-                 system_rhs,
-                 *block_precondition);
+    // Without a solution history the previous solution is the initial guess.
+    solution_history.initial_guess(lhs_matrix, system_rhs, solution_owned);
 
-    pcout << "  " << solver_control.last_step() << " GMRES iterations" << std::endl;
+    // Inner Krylov solves make the preconditioner vary between applications:
+    // in that case the outer solver must be flexible GMRES. With a fixed
+    // number of inner cycles the preconditioner is linear and GMRES is enough.
+    // The CGS2 variant is flexible, so it covers both cases.
+    if (options.gmres_orthogonalization == "cgs2")
+    {
+        SolverFGMRESCGS2 solver(solver_control);
+        solver.solve(lhs_matrix,
+                     solution_owned,
+                     system_rhs,
+                     *block_precondition);
+
+        pcout << "  " << solver_control.last_step() << " FGMRES iterations, "
+              << solver.n_reductions() << " reductions (MGS: "
+              << solver.n_reductions_mgs() << ")" << std::endl;
+    }
+    else if (block_precondition->is_variable())
+    {
+        SolverFGMRES<TrilinosWrappers::MPI::BlockVector> solver(solver_control);
+        solver.solve(lhs_matrix,
+                     solution_owned,
+                     system_rhs,
+                     *block_precondition);
 
-    solution = solution_owned;
+        pcout << "  " << solver_control.last_step() << " FGMRES iterations" << std::endl;
+    }
+    else
+    {
+        SolverGMRES<TrilinosWrappers::MPI::BlockVector> solver(solver_control);
+        solver.solve(lhs_matrix,
+                     solution_owned,
+                     system_rhs,
+                     *block_precondition);
+
+        pcout << "  " << solver_control.last_step() << " GMRES iterations" << std::endl;
+    }
+
+    solution_history.push(solution_owned);
+
+    solution_old = solution;
 
-    solution.update_ghost_values();
+    // The ghost entries of the new solution are received while the next
+    // assembly works on the interior cells (see GhostExchange).
+    ghost_exchange.start(solution_owned, solution);
 }
 
 template <unsigned int dim>
@@ -533,24 +1184,58 @@ void MonolithicNavierStokes<dim>::solve()
 
     VectorTools::interpolate(dof_handler, initial_condition, solution_owned);
     solution = solution_owned;
+    solution_old = solution;
 
     unsigned int time_step = 0;
+    double previous_time = time;
+
+    // Probes and output of the solution of a time step.
+    const auto postprocess = [&](const unsigned int step, const double step_time) {
+        if (probes)
+            probes->sample(step_time, solution);
+
+        output(step);
+    };
 
     assemble_base_matrix();
 
+    report_memory();
+
     while (time < T - 0.5 * deltat)
     {
         time += deltat;
         ++time_step;
 
+        // BDF2 needs two previous solutions: the first step is done with BDF1.
+        bdf_order = std::min(options.bdf_order, time_step);
+
         pcout << "n = " << std::setw(3) << time_step << ", t = " << std::setw(5)
               << time << ":" << std::flush;
 
         add_convective_term();
+
+        // The post-processing of the previous step needs the ghost values of
+        // its solution, which add_convective_term() has received by now: it is
+        // done here so that the exchange overlaps the interior cells.
+        if (time_step > 1)
+            postprocess(time_step - 1, previous_time);
+
         assemble_rhs();
         solve_time_step();
-        output(time_step);
+
+        previous_time = time;
     }
+
+    ghost_exchange.finish();
+    if (time_step > 0)
+        postprocess(time_step, previous_time);
+
+    // Throughput of the whole convective assembly (batched kernel, stabilization
+    // and PCD terms, global insertion), over all processes.
+    const double cells = Utilities::MPI::sum(static_cast<double>(n_convective_cells), MPI_COMM_WORLD);
+    const double assembly_time = Utilities::MPI::max(convective_assembly_time, MPI_COMM_WORLD);
+    pcout << "Convective assembly: " << cells / assembly_time << " cells/s ("
+          << convection_batch_kernel_name(dim, degree_velocity) << " kernel)" << std::endl;
 }
 
 template <unsigned int dim>
@@ -582,6 +1267,40 @@ void MonolithicNavierStokes<dim>::output(const unsigned int &time_step)
         output_dir, "output_", time_step, MPI_COMM_WORLD, 3);
 }
 
+template <unsigned int dim>
+void MonolithicNavierStokes<dim>::report_memory() const
+{
+    // Memory summed over all processes, in MB.
+    const auto total = [](const double bytes) {
+        return Utilities::MPI::sum(bytes, MPI_COMM_WORLD) / (1024.0 * 1024.0);
+    };
+
+    const double lhs_memory = total(lhs_matrix.memory_consumption());
+    const double operators_memory = total(stiffness_matrix.memory_consumption() +
+                                          velocity_mass.memory_consumption() +
+                                          pressure_mass.memory_consumption() +
+                                          pressure_laplace.memory_consumption() +
+                                          pressure_convection_diffusion.memory_consumption() +
+                                          direct_matrix.memory_consumption());
+    const double vectors_memory = total(system_rhs.memory_consumption() +
+                                        solution_owned.memory_consumption() +
+                                        solution.memory_consumption() +
+                                        solution_old.memory_consumption());
+
+    const double geometry_memory = total(geometry_cache.memory_consumption());
+
+    const double total_memory = lhs_memory + operators_memory + vectors_memory;
+
+    pcout << "  Memory of the linear system:" << std::endl;
+    pcout << "    system matrix   = " << lhs_memory << " MB" << std::endl;
+    pcout << "    other operators = " << operators_memory << " MB" << std::endl;
+    pcout << "    vectors         = " << vectors_memory << " MB" << std::endl;
+    pcout << "    per DoF         = " << total_memory * 1024.0 * 1024.0 / dof_handler.n_dofs() << " bytes" << std::endl;
+    pcout << "  Memory of the geometry cache = " << geometry_memory << " MB"
+          << (options.geometry_cache ? "" : " (geometry recomputed on the fly)") << std::endl;
+    pcout << "-----------------------------------------------" << std::endl;
+}
+
 template <unsigned int dim>
 void MonolithicNavierStokes<dim>::run()
 {
@@ -0,0 +1,287 @@
+#include "../include/Probes.hpp"
+
+template <int dim>
+Probes<dim>::Probes(const std::string &probes_file_name_)
+    : probes_file_name(probes_file_name_)
+    , mpi_size(Utilities::MPI::n_mpi_processes(MPI_COMM_WORLD))
+    , mpi_rank(Utilities::MPI::this_mpi_process(MPI_COMM_WORLD))
+    , mapping(FE_SimplexP<dim>(1))
+{
+    read_probes_file();
+}
+
+template <int dim>
+void Probes<dim>::read_probes_file()
+{
+    std::ifstream file(probes_file_name);
+    AssertThrow(file,
+                ExcMessage("Could not open probes file '" + probes_file_name + "'"));
+
+    const auto read_point = [](std::istringstream &stream) {
+        Point<dim> p;
+        for (unsigned int d = 0; d < dim; ++d)
+            stream >> p[d];
+        return p;
+    };
+
+    std::string line;
+    while (std::getline(file, line))
+    {
+        std::istringstream stream(line);
+        std::string type;
+        stream >> type;
+
+        if (type.empty() || type[0] == '#')
+            continue;
+
+        if (type == "point")
+        {
+            const Point<dim> p = read_point(stream);
+            AssertThrow(!stream.fail(), ExcMessage("Invalid probe definition: " + line));
+
+            points.push_back(p);
+        }
+        else if (type == "line")
+        {
+            const Point<dim> start = read_point(stream);
+            const Point<dim> end = read_point(stream);
+            unsigned int n = 0;
+            stream >> n;
+            AssertThrow(!stream.fail() && n >= 2,
+                        ExcMessage("Invalid probe definition: " + line));
+
+            for (unsigned int k = 0; k < n; ++k)
+                points.push_back(start + (static_cast<double>(k) / (n - 1)) * (end - start));
+        }
+        else if (type == "plane")
+        {
+            const Point<dim> origin = read_point(stream);
+            const Tensor<1, dim> a = read_point(stream);
+            const Tensor<1, dim> b = read_point(stream);
+            unsigned int n_a = 0;
+            unsigned int n_b = 0;
+            stream >> n_a >> n_b;
+            AssertThrow(!stream.fail() && n_a >= 2 && n_b >= 2,
+                        ExcMessage("Invalid probe definition: " + line));
+
+            for (unsigned int j = 0; j < n_b; ++j)
+                for (unsigned int i = 0; i < n_a; ++i)
+                    points.push_back(origin +
+                                     (static_cast<double>(i) / (n_a - 1)) * a +
+                                     (static_cast<double>(j) / (n_b - 1)) * b);
+        }
+        else
+        {
+            AssertThrow(false,
+                        ExcMessage("Unknown probe type '" + type + "' in line: " + line));
+        }
+    }
+}
+
+template <int dim>
+void Probes<dim>::initialize(const std::vector<const DoFHandler<dim> *> &dof_handlers_,
+                             const std::vector<std::vector<std::string>> &component_names_,
+                             const std::string &output_file_name)
+{
+    AssertThrow(!dof_handlers_.empty(), ExcMessage("At least one DoF handler is required."));
+    AssertDimension(dof_handlers_.size(), component_names_.size());
+
+    const Triangulation<dim> &triangulation = dof_handlers_[0]->get_triangulation();
+
+    // Column layout of the output: all the components of the first DoF
+    // handler, then all the components of the second one, and so on.
+    component_offsets.resize(dof_handlers_.size());
+    n_components = 0;
+    for (unsigned int f = 0; f < dof_handlers_.size(); ++f)
+    {
+        AssertDimension(component_names_[f].size(), dof_handlers_[f]->get_fe().n_components());
+        component_offsets[f] = n_components;
+        n_components += dof_handlers_[f]->get_fe().n_components();
+    }
+
+    // Locate the probes. Consecutive probes of a line or plane are close
+    // to each other, so the last cell found is a good hint for the next one.
+    // Points on a partition interface may be found by several processes:
+    // the lowest rank among those owning a containing cell keeps the probe.
+    GridTools::Cache<dim> cache(triangulation, mapping);
+
+    std::vector<unsigned int> local_owners(points.size(), mpi_size);
+    std::vector<typename Triangulation<dim>::active_cell_iterator> cells(points.size());
+    std::vector<Point<dim>> reference_points(points.size());
+
+    typename Triangulation<dim>::active_cell_iterator hint = triangulation.begin_active();
+
+    for (unsigned int k = 0; k < points.size(); ++k)
+    {
+        try
+        {
+            const auto cell_and_point =
+                GridTools::find_active_cell_around_point(cache, points[k], hint);
+
+            if (cell_and_point.first.state() != IteratorState::valid)
+                continue;
+
+            hint = cell_and_point.first;
+
+            // On a partition interface the cell found may be a ghost while
+            // another cell containing the point is owned, and the process
+            // owning that ghost may in turn find one of our cells: check
+            // all the cells around the point, so that at least one process
+            // claims the probe.
+            const auto cells_around_point = GridTools::find_all_active_cells_around_point(
+                mapping, triangulation, points[k], 1e-10, cell_and_point);
+
+            for (const auto &candidate : cells_around_point)
+            {
+                if (candidate.first->is_locally_owned())
+                {
+                    local_owners[k] = mpi_rank;
+                    cells[k] = candidate.first;
+                    reference_points[k] = candidate.second;
+                    break;
+                }
+            }
+        }
+        catch (const GridTools::ExcPointNotFound<dim> &)
+        {
+            // The point is not in the part of the mesh known to this process.
+        }
+    }
+
+    owners.resize(points.size());
+    MPI_Allreduce(local_owners.data(), owners.data(), points.size(),
+                  MPI_UNSIGNED, MPI_MIN, MPI_COMM_WORLD);
+
+    // Cache DoF indices and shape function values of the owned probes.
+    field_data.assign(points.size(), std::vector<FieldData>(dof_handlers_.size()));
+
+    for (unsigned int k = 0; k < points.size(); ++k)
+    {
+        if (owners[k] != mpi_rank)
+            continue;
+
+        for (unsigned int f = 0; f < dof_handlers_.size(); ++f)
+        {
+            const FiniteElement<dim> &fe = dof_handlers_[f]->get_fe();
+            const unsigned int dofs_per_cell = fe.dofs_per_cell;
+
+            const typename DoFHandler<dim>::active_cell_iterator dof_cell(
+                &triangulation, cells[k]->level(), cells[k]->index(), dof_handlers_[f]);
+
+            FieldData &data = field_data[k][f];
+            data.dof_indices.resize(dofs_per_cell);
+            data.components.resize(dofs_per_cell);
+            data.shape_values.resize(dofs_per_cell);
+
+            dof_cell->get_dof_indices(data.dof_indices);
+
+            for (unsigned int i = 0; i < dofs_per_cell; ++i)
+            {
+                data.components[i] = fe.system_to_component_index(i).first;
+                data.shape_values[i] = fe.shape_value(i, reference_points[k]);
+            }
+        }
+    }
+
+    local_values.assign(points.size() * n_components, 0.0);
+    global_values.assign(points.size() * n_components, 0.0);
+
+    // Write the header of the output file.
+    if (mpi_rank == 0)
+    {
+        output_file.open(output_file_name);
+        AssertThrow(output_file,
+                    ExcMessage("Could not open probes output file '" + output_file_name + "'"));
+        output_file.precision(12);
+
+        unsigned int n_not_found = 0;
+
+        output_file << "# probes defined in " << probes_file_name << "\n";
+        for (unsigned int k = 0; k < points.size(); ++k)
+        {
+            output_file << "# probe " << k << ": " << points[k];
+            if (owners[k] == mpi_size)
+            {
+                output_file << " (not found in the mesh)";
+                ++n_not_found;
+            }
+            output_file << "\n";
+        }
+
+        output_file << "time";
+        for (unsigned int k = 0; k < points.size(); ++k)
+            for (unsigned int f = 0; f < component_names_.size(); ++f)
+                for (const auto &name : component_names_[f])
+                    output_file << ",probe" << k << "_" << name;
+        output_file << "\n";
+
+        if (n_not_found > 0)
+            std::cerr << "Warning: " << n_not_found
+                      << " probes are outside the mesh and will be written as nan." << std::endl;
+    }
+}
+
+template <int dim>
+template <typename VectorType>
+void Probes<dim>::sample(const double &time, const std::vector<const VectorType *> &solutions)
+{
+    AssertDimension(solutions.size(), component_offsets.size());
+
+    std::fill(local_values.begin(), local_values.end(), 0.0);
+
+    for (unsigned int k = 0; k < points.size(); ++k)
+    {
+        if (owners[k] != mpi_rank)
+            continue;
+
+        double *values = &local_values[k * n_components];
+
+        for (unsigned int f = 0; f < solutions.size(); ++f)
+        {
+            const FieldData &data = field_data[k][f];
+            const VectorType &solution = *solutions[f];
+
+            for (unsigned int i = 0; i < data.dof_indices.size(); ++i)
+                values[component_offsets[f] + data.components[i]] +=
+                    solution(data.dof_indices[i]) * data.shape_values[i];
+        }
+    }
+
+    // Every probe has exactly one owner, so a sum gathers all the values.
+    MPI_Reduce(local_values.data(), global_values.data(), local_values.size(),
+               MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+
+    if (mpi_rank == 0)
+    {
+        output_file << time;
+        for (unsigned int k = 0; k < points.size(); ++k)
+            for (unsigned int c = 0; c < n_components; ++c)
+            {
+                if (owners[k] == mpi_size)
+                    output_file << ",nan";
+                else
+                    output_file << "," << global_values[k * n_components + c];
+            }
+        output_file << "\n";
+    }
+}
+
+template <int dim>
+template <typename VectorType>
+void Probes<dim>::sample(const double &time, const VectorType &solution)
+{
+    sample(time, std::vector<const VectorType *>(1, &solution));
+}
+
+template class Probes<2>;
+template class Probes<3>;
+
+template void Probes<2>::sample(const double &, const std::vector<const TrilinosWrappers::MPI::Vector *> &);
+template void Probes<2>::sample(const double &, const std::vector<const TrilinosWrappers::MPI::BlockVector *> &);
+template void Probes<2>::sample(const double &, const TrilinosWrappers::MPI::Vector &);
+template void Probes<2>::sample(const double &, const TrilinosWrappers::MPI::BlockVector &);
+
+template void Probes<3>::sample(const double &, const std::vector<const TrilinosWrappers::MPI::Vector *> &);
+template void Probes<3>::sample(const double &, const std::vector<const TrilinosWrappers::MPI::BlockVector *> &);
+template void Probes<3>::sample(const double &, const TrilinosWrappers::MPI::Vector &);
+template void Probes<3>::sample(const double &, const TrilinosWrappers::MPI::BlockVector &);
@@ -1,4 +1,7 @@
 #include "../include/SteadyNavierStokes.hpp"
+#include "../include/preconditioners.hpp"
+#include "../include/Stabilization.hpp"
+#include "../include/SolverFGMRESCGS2.hpp"
 
 // -----------------------------------------------------------
 // SteadyNavierStokes methods
@@ -7,38 +10,129 @@
 template <int dim>
 void SteadyNavierStokes<dim>::run_full_problem_pipeline()
 {
+  if (!this->options.reynolds_sweep.empty())
+  {
+    this->run_reynolds_sweep();
+    return;
+  }
+
   this->pcout << "==============================================="      << std::endl;
   this->pcout << "Running full pipeline: Stokes -> NonLinearCorrection" << std::endl;
   this->pcout << "==============================================="      << std::endl;
 
-  // 1) Create a Stokes solver with this object's parameters
-  Stokes<dim> stokes_problem(this->mesh_file_name,
-                             this->degree_velocity,
-                             this->degree_pressure,
-                             this->Re);
-
-  // 2) Run the typical steps: setup, assemble, solve, output
-  stokes_problem.setup();
-  stokes_problem.assemble();
-  stokes_problem.solve();
-  stokes_problem.output();
-
-  // 3) Retrieve the final solution of the Stokes problem
-  TrilinosWrappers::MPI::BlockVector stokes_solution = stokes_problem.get_solution();
+  // 1) Create the solver with this object's parameters
+  NonLinearCorrection<dim> non_linear_correction(this->mesh_file_name,
+                                                 this->degree_velocity,
+                                                 this->degree_pressure,
+                                                 this->Re,
+                                                 this->options);
 
-  // 4) Create a NonLinearCorrection solver object from the Stokes problem object
-  NonLinearCorrection<dim> non_linear_correction(stokes_problem);
+  // 2) Mesh, DoFs, constraints, sparsity patterns and vectors, shared by
+  //    the Stokes and the Newton stages
+  non_linear_correction.setup();
 
-  // 5) Set the initial condition of the incremental solver to the Stokes solution
-  non_linear_correction.set_initial_conditions(stokes_solution);
+  // 3) Solve Stokes on the shared system; its solution becomes the
+  //    initial condition of the incremental solver
+  non_linear_correction.solve_stokes();
 
-  // 6) Run the incremental solver steps
-  non_linear_correction.setup();
+  // 4) Run the incremental solver steps
   non_linear_correction.solve();   // Assemble called inside solve() for each iteration
   non_linear_correction.output();
 
-  // 7) Compute lift, drag and pressure difference
+  // 5) Compute lift, drag and pressure difference
   non_linear_correction.compute_lift_drag();
+
+  // 6) Sample the solution at the probes, if any
+  if (!this->options.probes_file.empty())
+    non_linear_correction.sample_probes();
+}
+
+template <int dim>
+void SteadyNavierStokes<dim>::run_reynolds_sweep()
+{
+  const std::vector<double> &reynolds_numbers = this->options.reynolds_sweep;
+
+  this->pcout << "==============================================="      << std::endl;
+  this->pcout << "Reynolds sweep: " << reynolds_numbers.size() << " values of Re" << std::endl;
+  this->pcout << "==============================================="      << std::endl;
+
+  const auto setup_start = std::chrono::steady_clock::now();
+
+  // 1) Mesh, DoFs, constraints, sparsity patterns, geometry cache and the
+  //    augmented-Lagrangian preconditioner are built once and shared by all
+  //    the Reynolds numbers
+  NonLinearCorrection<dim> non_linear_correction(this->mesh_file_name,
+                                                 this->degree_velocity,
+                                                 this->degree_pressure,
+                                                 reynolds_numbers.front(),
+                                                 this->options);
+  non_linear_correction.setup();
+
+  // 2) The Stokes solution is the initial guess of the first Re only
+  non_linear_correction.solve_stokes(false);
+
+  const double setup_time =
+    std::chrono::duration<double>(std::chrono::steady_clock::now() - setup_start).count();
+
+  std::vector<unsigned int> newton_iterations;
+  std::vector<double>       drag_coefficients;
+  std::vector<double>       lift_coefficients;
+  std::vector<double>       solve_times;
+
+  for (const double Re_sweep : reynolds_numbers)
+  {
+    this->pcout << "-----------------------------------------------" << std::endl;
+    this->pcout << "Re = " << Re_sweep << std::endl;
+
+    // 3) Continuation: the Newton iterations start from the solution
+    //    converged at the previous Re, kept in solution_old
+    non_linear_correction.set_reynolds_number(Re_sweep);
+
+    const auto solve_start = std::chrono::steady_clock::now();
+    non_linear_correction.solve();
+    solve_times.push_back(
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - solve_start).count());
+
+    non_linear_correction.output();
+    non_linear_correction.compute_lift_drag();
+
+    if (!this->options.probes_file.empty())
+      non_linear_correction.sample_probes();
+
+    newton_iterations.push_back(non_linear_correction.get_newton_iterations());
+    drag_coefficients.push_back(non_linear_correction.get_drag());
+    lift_coefficients.push_back(non_linear_correction.get_lift());
+  }
+
+  // 4) Summary, also written next to the output directories of every Re
+  if (this->mpi_rank == 0)
+  {
+    const std::filesystem::path sweep_file =
+      std::filesystem::path(non_linear_correction.get_output_directory()).parent_path() / "reynolds_sweep.csv";
+
+    std::ofstream output_file(sweep_file);
+    output_file << "Re,newton_iterations,drag,lift,solve_time\n";
+
+    std::cout << "===============================================" << std::endl;
+    std::cout << "Reynolds sweep summary (setup " << setup_time << " s)" << std::endl;
+    std::cout << std::setw(10) << "Re" << std::setw(8) << "Newton"
+              << std::setw(14) << "cD" << std::setw(14) << "cL"
+              << std::setw(12) << "time [s]" << std::endl;
+
+    for (unsigned int k = 0; k < reynolds_numbers.size(); ++k)
+    {
+      std::cout << std::setw(10) << reynolds_numbers[k] << std::setw(8) << newton_iterations[k]
+                << std::setw(14) << drag_coefficients[k] << std::setw(14) << lift_coefficients[k]
+                << std::setw(12) << solve_times[k] << std::endl;
+
+      output_file << reynolds_numbers[k] << "," << newton_iterations[k] << ","
+                  << drag_coefficients[k] << "," << lift_coefficients[k] << ","
+                  << solve_times[k] << "\n";
+    }
+
+    std::cout << "Wrote " << sweep_file.string() << std::endl;
+    std::cout << "===============================================" << std::endl;
+  }
 }
 
 template <int dim>
@@ -161,16 +255,50 @@ void Stokes<dim>::setup()
 
   this->pcout << "-----------------------------------------------" << std::endl;
 
+  // Dirichlet constraints on the velocity. They are condensed during
+  // assembly, so the same constraints and sparsity patterns serve the
+  // Stokes problem and the Newton iterations of NonLinearCorrection.
+  {
+    constraints.clear();
+    std::map<types::boundary_id, const Function<dim> *> boundary_functions;
+    Functions::ZeroFunction<dim> zero_function(dim + 1);
+
+    // Dirichlet Boundary Conditions
+      boundary_functions[0] = &this->inlet_velocity;  // Inlet
+      boundary_functions[2] = &zero_function;         // Walls - No-slip
+      boundary_functions[3] = &zero_function;         // Obstacle - No-slip
+
+    if constexpr (dim == 2)
+    {
+      VectorTools::interpolate_boundary_values(this->dof_handler,
+                                               boundary_functions,
+                                               constraints,
+                                               ComponentMask({true,true,false,false}));
+    }
+    else if constexpr (dim == 3)
+    {
+      VectorTools::interpolate_boundary_values(this->dof_handler,
+                                               boundary_functions,
+                                               constraints,
+                                               ComponentMask({true,true,true,false}));
+    }
+
+    constraints.close();
+  }
+
   {
     this->pcout << "Initializing the linear system" << std::endl;
     this->pcout << "  Initializing the sparsity pattern" << std::endl;
 
+    // The Newton iterations couple every velocity component. The PSPG
+    // term couples pressure to pressure: the (1,1) block is only
+    // allocated when the stabilization is active.
     Table<2, DoFTools::Coupling> coupling(dim + 1, dim + 1);
     for (unsigned int c = 0; c < dim + 1; ++c)
       for (unsigned int d = 0; d < dim + 1; ++d)
       {
         if (c == dim && d == dim)
-          coupling[c][d] = DoFTools::none;
+          coupling[c][d] = this->options.stabilization ? DoFTools::always : DoFTools::none;
         else
           coupling[c][d] = DoFTools::always;
       }
@@ -179,7 +307,9 @@ void Stokes<dim>::setup()
                                                     MPI_COMM_WORLD);
     DoFTools::make_sparsity_pattern(this->dof_handler,
                                     coupling,
-                                    sparsity);
+                                    sparsity,
+                                    constraints,
+                                    false);
     sparsity.compress();
 
     for (unsigned int c = 0; c < dim + 1; ++c)
@@ -195,7 +325,9 @@ void Stokes<dim>::setup()
         this->block_owned_dofs, MPI_COMM_WORLD);
     DoFTools::make_sparsity_pattern(this->dof_handler,
                                     coupling,
-                                    sparsity_pressure_mass);
+                                    sparsity_pressure_mass,
+                                    constraints,
+                                    false);
     sparsity_pressure_mass.compress();
 
     this->pcout << "  Initializing the matrices" << std::endl;
@@ -211,6 +343,12 @@ void Stokes<dim>::setup()
                           this->block_relevant_dofs,
                           MPI_COMM_WORLD);
   }
+
+  // The mesh is fixed: the Stokes and Newton assemblies loop over the
+  // owned cells collected once, with the shape functions of the
+  // reference cell.
+  this->geometry_cache.reinit(this->dof_handler, this->options.geometry_cache);
+  this->shapes.reinit(*this->fe, *this->quadrature);
 }
 
 template <int dim>
@@ -220,13 +358,9 @@ void Stokes<dim>::assemble()
   this->pcout << "Assembling the system" << std::endl;
 
   const unsigned int dofs_per_cell = this->fe->dofs_per_cell;
-  const unsigned int n_q           = this->quadrature->size();
+  const unsigned int n_q           = this->shapes.n_q();
   const unsigned int n_q_face      = this->quadrature_face->size();
 
-  FEValues<dim> fe_values(*this->fe, *this->quadrature,
-                          update_values | update_gradients |
-                            update_quadrature_points | update_JxW_values);
-
   FEFaceValues<dim> fe_face_values(*this->fe, *this->quadrature_face,
                                    update_values | update_normal_vectors |
                                      update_JxW_values);
@@ -235,62 +369,111 @@ void Stokes<dim>::assemble()
   FullMatrix<double> cell_pressure_mass_matrix(dofs_per_cell, dofs_per_cell);
   Vector<double>     cell_rhs(dofs_per_cell);
 
-  std::vector<types::global_dof_index> dof_indices(dofs_per_cell);
-
   this->system_matrix = 0.0;
   this->system_rhs    = 0.0;
   this->pressure_mass = 0.0;
 
   FEValuesExtractors::Vector velocity(0);
-  FEValuesExtractors::Scalar pressure(dim);
 
-  for (const auto &cell : this->dof_handler.active_cell_iterators())
+  Vector<double> forcing_loc(dim);
+
+  std::vector<double>         div_phi_u(dofs_per_cell);
+  std::vector<Tensor<1, dim>> phi_u(dofs_per_cell);
+  std::vector<Tensor<2, dim>> grad_phi_u(dofs_per_cell);
+  std::vector<double>         phi_p(dofs_per_cell);
+  std::vector<Tensor<1, dim>> grad_phi_p(dofs_per_cell);
+
+  for (unsigned int c = 0; c < this->geometry_cache.size(); ++c)
   {
-    if (!cell->is_locally_owned())
-      continue;
+    const auto &cell = this->geometry_cache.cell(c);
+    const CellGeometry<dim> geometry = this->geometry_cache.geometry(c);
+    const std::vector<types::global_dof_index> &dof_indices = this->geometry_cache.cell_dof_indices(c);
 
-    fe_values.reinit(cell);
     cell_matrix               = 0.0;
     cell_rhs                  = 0.0;
     cell_pressure_mass_matrix = 0.0;
 
+    // PSPG parameter of the Stokes problem (no convection, no time derivative).
+    const double tau = this->options.stabilization
+                         ? compute_stabilization_parameter(geometry.diameter / this->degree_velocity,
+                                                           0.0, this->nu, 0.0)
+                         : 0.0;
+
     for (unsigned int q = 0; q < n_q; ++q)
     {
-      Vector<double> forcing_loc(dim);
-      this->forcing_term.vector_value(fe_values.quadrature_point(q), forcing_loc);
+      const double JxW = this->shapes.weight(q) * geometry.jacobian_determinant;
+
+      this->forcing_term.vector_value(geometry.quadrature_point(this->shapes.point(q)), forcing_loc);
       Tensor<1, dim> forcing_tensor;
 
       for (unsigned int d = 0; d < dim; ++d)
         forcing_tensor[d] = forcing_loc[d];
 
+      // Shape function k is nonzero only in its component: a velocity
+      // component (φ_k = ϕ_k e_c) or the pressure (ψ_k = ϕ_k).
+      for (unsigned int k = 0; k < dofs_per_cell; ++k)
+      {
+        const unsigned int   component = this->shapes.component(k);
+        const Tensor<1, dim> gradient  = this->shapes.gradient(k, q, geometry.inverse_jacobian);
+
+        div_phi_u[k]  = 0.0;
+        grad_phi_u[k] = 0.0;
+        phi_u[k]      = 0.0;
+        phi_p[k]      = 0.0;
+        grad_phi_p[k] = 0.0;
+
+        if (component < dim)
+        {
+          div_phi_u[k]             = gradient[component];
+          grad_phi_u[k][component] = gradient;
+          phi_u[k][component]      = this->shapes.value(k, q);
+        }
+        else
+        {
+          phi_p[k]      = this->shapes.value(k, q);
+          grad_phi_p[k] = gradient;
+        }
+      }
+
       for (unsigned int i = 0; i < dofs_per_cell; ++i)
       {
         for (unsigned int j = 0; j < dofs_per_cell; ++j)
         {
           cell_matrix(i, j) += this->nu 
-                               * scalar_product(fe_values[velocity].gradient(i, q),
-                                                 fe_values[velocity].gradient(j, q))
-                               * fe_values.JxW(q);
+                               * scalar_product(grad_phi_u[i], grad_phi_u[j])
+                               * JxW;
+
+          cell_matrix(i, j) -= div_phi_u[i]
+                               * phi_p[j]
+                               * JxW;
 
-          cell_matrix(i, j) -= fe_values[velocity].divergence(i, q)
-                               * fe_values[pressure].value(j, q)
-                               * fe_values.JxW(q);
+          cell_matrix(i, j) -= div_phi_u[j]
+                               * phi_p[i]
+                               * JxW;
 
-          cell_matrix(i, j) -= fe_values[velocity].divergence(j, q)
-                               * fe_values[pressure].value(i, q)
-                               * fe_values.JxW(q);
+          // PSPG stabilization: -τ (∇p, ∇q), with the sign of the
+          // continuity equation -(∇·u, q) = 0
+          if (this->options.stabilization)
+            cell_matrix(i, j) -= tau
+                                 * grad_phi_p[i]
+                                 * grad_phi_p[j]
+                                 * JxW;
 
           cell_pressure_mass_matrix(i, j) +=
-                               fe_values[pressure].value(i, q)
-                               * fe_values[pressure].value(j, q)
+                               phi_p[i]
+                               * phi_p[j]
                                / this->nu 
-                               * fe_values.JxW(q);
+                               * JxW;
         }
 
         // Forcing
-        cell_rhs(i) += scalar_product(forcing_tensor,
-                                      fe_values[velocity].value(i, q))
-                       * fe_values.JxW(q);
+        cell_rhs(i) += scalar_product(forcing_tensor, phi_u[i])
+                       * JxW;
+
+        if (this->options.stabilization)
+          cell_rhs(i) -= tau
+                         * scalar_product(forcing_tensor, grad_phi_p[i])
+                         * JxW;
       }
     }
 
@@ -319,55 +502,20 @@ void Stokes<dim>::assemble()
       }
     }
 
-    cell->get_dof_indices(dof_indices);
-    this->system_matrix.add(dof_indices, cell_matrix);
-    this->system_rhs.add(dof_indices, cell_rhs);
-    this->pressure_mass.add(dof_indices, cell_pressure_mass_matrix);
+    // Dirichlet boundary conditions are condensed here
+    constraints.distribute_local_to_global(cell_matrix,
+                                           cell_rhs,
+                                           dof_indices,
+                                           this->system_matrix,
+                                           this->system_rhs);
+    constraints.distribute_local_to_global(cell_pressure_mass_matrix,
+                                           dof_indices,
+                                           this->pressure_mass);
   }
 
   this->system_matrix.compress(VectorOperation::add);
   this->system_rhs.compress(VectorOperation::add);
   this->pressure_mass.compress(VectorOperation::add);
-
-  // Dirichlet boundary conditions
-  {
-    std::map<types::global_dof_index, double> boundary_values;
-    std::map<types::boundary_id, const Function<dim> *> boundary_functions;
-
-    Functions::ZeroFunction<dim> zero_function(dim + 1);
-
-    // Dirichlet Boundary Conditions
-      boundary_functions[0] = &this->inlet_velocity;  // Inlet
-      boundary_functions[2] = &zero_function;         // Walls - No-slip
-      boundary_functions[3] = &zero_function;         // Obstacle - No-slip
-    
-    if constexpr (dim == 2)
-    {
-      // Interpolate boundary values into constraints (only velocity components)
-      VectorTools::interpolate_boundary_values(
-      this->dof_handler,
-      boundary_functions,
-      boundary_values,
-      ComponentMask({true,true, false ,false}));
-    }
-    else if constexpr (dim == 3)
-    {
-      // Interpolate boundary values into constraints (only velocity components)
-      VectorTools::interpolate_boundary_values(
-      this->dof_handler,
-      boundary_functions,
-      boundary_values,
-      ComponentMask({true,true, true,false}));
-    }
-
-    // Apply them
-    MatrixTools::apply_boundary_values(boundary_values,
-                                       this->system_matrix,
-                                       this->solution_owned,
-                                       this->system_rhs,
-                                       false);
-                                       
-  }
 }
 
 
@@ -386,8 +534,10 @@ void Stokes<dim>::solve()
                             this->system_matrix.block(1,0));
 
   this->pcout << "Solving the linear system" << std::endl;
+  constraints.set_zero(this->solution_owned);
   solver.solve(this->system_matrix, this->solution_owned,
                this->system_rhs, preconditioner);
+  constraints.distribute(this->solution_owned);
   this->pcout << "  " << solver_control.last_step() << " GMRES iterations"
               << std::endl;
 
@@ -431,8 +581,9 @@ void Stokes<dim>::output()
   std::string numProcessors = std::to_string(this->mpi_size);
   numProcessors += (this->mpi_size == 1) ? "_processor" : "_processors";
 
+  // Qualified call: NonLinearCorrection writes its Stokes stage here too
   const std::string output_file_name = "output-Stokes-" + numProcessors;
-  data_out.write_vtu_with_pvtu_record(this->get_output_directory(),
+  data_out.write_vtu_with_pvtu_record(Stokes<dim>::get_output_directory(),
                                       output_file_name,
                                       0,
                                       MPI_COMM_WORLD);
@@ -475,134 +626,30 @@ std::string Stokes<dim>::get_output_directory() const
 template <int dim>
 void NonLinearCorrection<dim>::setup()
 {
-  // We do NOT read the mesh again because it was already copied in the construtor.
-  // We do want to initialize the FE system, quadrature, etc.
-
-  this->pcout << "Initializing the finite element space" << std::endl;
-
-  const FE_SimplexP<dim> fe_scalar_velocity(this->degree_velocity);
-  const FE_SimplexP<dim> fe_scalar_pressure(this->degree_pressure);
-  this->fe = std::make_unique<FESystem<dim>>(fe_scalar_velocity, dim,
-                                             fe_scalar_pressure,   1);
-
-  this->pcout << "  Velocity degree:           = "
-              << fe_scalar_velocity.degree << std::endl;
-  this->pcout << "  Pressure degree:           = "
-              << fe_scalar_pressure.degree << std::endl;
-  this->pcout << "  DoFs per cell              = "
-              << this->fe->dofs_per_cell << std::endl;
-
-  this->quadrature = std::make_unique<QGaussSimplex<dim>>(this->fe->degree + 1);
-  this->pcout << "  Quadrature points per cell = "
-              << this->quadrature->size() << std::endl;
-
-  this->quadrature_face =
-      std::make_unique<QGaussSimplex<dim - 1>>(this->fe->degree + 1);
-  this->pcout << "  Quadrature points per face = "
-              << this->quadrature_face->size() << std::endl;
-  this->pcout << "-----------------------------------------------" << std::endl;
-
-  // Initialize the DoF handler
-  this->pcout << "Initializing the DoF handler" << std::endl;
-  this->dof_handler.reinit(this->mesh);
-  this->dof_handler.distribute_dofs(*this->fe);
-
-  std::vector<unsigned int> block_component(dim + 1, 0);
-  block_component[dim] = 1;
-  DoFRenumbering::component_wise(this->dof_handler, block_component);
-
-  this->locally_owned_dofs = this->dof_handler.locally_owned_dofs();
-  DoFTools::extract_locally_relevant_dofs(this->dof_handler,
-                                          this->locally_relevant_dofs);
-
-  std::vector<types::global_dof_index> dofs_per_block =
-      DoFTools::count_dofs_per_fe_block(this->dof_handler, block_component);
-  const unsigned int n_u = dofs_per_block[0];
-  const unsigned int n_p = dofs_per_block[1];
-
-  this->block_owned_dofs.resize(2);
-  this->block_relevant_dofs.resize(2);
-  this->block_owned_dofs[0]    = this->locally_owned_dofs.get_view(0, n_u);
-  this->block_owned_dofs[1]    = this->locally_owned_dofs.get_view(n_u, n_u + n_p);
-  this->block_relevant_dofs[0] = this->locally_relevant_dofs.get_view(0, n_u);
-  this->block_relevant_dofs[1] = this->locally_relevant_dofs.get_view(n_u, n_u + n_p);
-
-  this->pcout << "  Number of DoFs: " << std::endl
-              << "    velocity = " << n_u << std::endl
-              << "    pressure = " << n_p << std::endl
-              << "    total    = " << (n_u + n_p) << std::endl;
-  this->pcout << "-----------------------------------------------" << std::endl;
-
-  // Initialize constraints
-  {
-    constraints.clear();
-    std::map<types::boundary_id, const Function<dim> *> boundary_functions;
-    Functions::ZeroFunction<dim> zero_function(dim + 1);
-
-    // Dirichlet Boundary Conditions
-      boundary_functions[0] = &this->inlet_velocity;  // Inlet
-      boundary_functions[2] = &zero_function;         // Walls - No-Slip
-      boundary_functions[3] = &zero_function;         // Obstacle - No-Slip
-
-    if constexpr (dim == 2)
-    {
-      VectorTools::interpolate_boundary_values(this->dof_handler,
-                                             boundary_functions,
-                                             constraints,
-                                             ComponentMask({true,true,false,false}));
-    }
-    else if constexpr (dim == 3)
-    {
-      VectorTools::interpolate_boundary_values(this->dof_handler,
-                                             boundary_functions,
-                                             constraints,
-                                             ComponentMask({true,true,true,false}));
-    }
+  // Mesh, DoFs, constraints, sparsity patterns, matrices, vectors and
+  // geometry cache are those of the Stokes problem, set up once for both
+  // stages.
+  Stokes<dim>::setup();
+
+  solution_old.reinit(this->block_owned_dofs, this->block_relevant_dofs, MPI_COMM_WORLD);
+  current_iterate.reinit(this->block_owned_dofs, MPI_COMM_WORLD);
+  newton_update.reinit(this->block_owned_dofs, MPI_COMM_WORLD);
+  residual.reinit(this->block_owned_dofs, MPI_COMM_WORLD);
+}
 
-    constraints.close();
-  }
+template <int dim>
+void NonLinearCorrection<dim>::solve_stokes(const bool write_output)
+{
+  Stokes<dim>::assemble();
+  Stokes<dim>::solve();
 
-  this->pcout << "Initializing the linear system" << std::endl;
-  this->pcout << "Initializing the sparsity pattern" << std::endl;
-
-  Table<2, DoFTools::Coupling> coupling(dim + 1, dim + 1);
-  for (unsigned int c = 0; c < dim + 1; ++c)
-    for (unsigned int d = 0; d < dim + 1; ++d)
-      coupling[c][d] = DoFTools::always; 
-
-  TrilinosWrappers::BlockSparsityPattern sparsity(this->block_owned_dofs,
-                                                  MPI_COMM_WORLD);
-  DoFTools::make_sparsity_pattern(this->dof_handler,
-                                  coupling,
-                                  sparsity,
-                                  constraints,
-                                  false);
-  sparsity.compress();
-
-  for (unsigned int c = 0; c < dim + 1; ++c)
-    for (unsigned int d = 0; d < dim + 1; ++d)
-    {
-      if (c == dim && d == dim)
-        coupling[c][d] = DoFTools::always;
-      else
-        coupling[c][d] = DoFTools::none;
-    }
+  if (write_output)
+    Stokes<dim>::output();
 
-  TrilinosWrappers::BlockSparsityPattern sparsity_pressure_mass(
-      this->block_owned_dofs, MPI_COMM_WORLD);
-  DoFTools::make_sparsity_pattern(this->dof_handler,
-                                  coupling,
-                                  sparsity_pressure_mass,
-                                  constraints,
-                                  false);
-  sparsity_pressure_mass.compress();
-
-  this->system_matrix.reinit(sparsity);
-  this->pressure_mass.reinit(sparsity_pressure_mass);
-
-  this->system_rhs.reinit(this->block_owned_dofs, MPI_COMM_WORLD);
-  this->solution_owned.reinit(this->block_owned_dofs, MPI_COMM_WORLD);
-  this->solution.reinit(this->block_owned_dofs, this->block_relevant_dofs, MPI_COMM_WORLD);
+  // The Stokes solution is the initial guess of the Newton iterations.
+  // Both vectors have the same layout, so they are swapped instead of
+  // copied: solution is overwritten by the first Newton step.
+  solution_old.swap(this->solution);
 }
 
 template <int dim>
@@ -612,52 +659,106 @@ void NonLinearCorrection<dim>::assemble()
   const unsigned int n_q           = this->quadrature->size();
   const unsigned int n_q_face      = this->quadrature_face->size();
 
-  FEValues<dim> fe_values(*this->fe, *this->quadrature,
-                          update_values | update_gradients |
-                            update_quadrature_points | update_JxW_values);
-
   FEFaceValues<dim> fe_face_values(*this->fe, *this->quadrature_face,
                                    update_values | update_normal_vectors |
                                      update_JxW_values);
 
-  std::vector<types::global_dof_index> dof_indices(dofs_per_cell);
   FullMatrix<double> local_matrix(dofs_per_cell, dofs_per_cell);
+  FullMatrix<double> local_pressure_mass(dofs_per_cell, dofs_per_cell);
   Vector<double>     local_rhs(dofs_per_cell);
 
+  // The pressure mass matrix is only needed by the augmented-Lagrangian preconditioner.
+  const bool assemble_pressure_mass = (this->options.preconditioner == "augmented-lagrangian");
+  const double gamma = this->options.grad_div;
+
   this->system_matrix = 0.0;
   this->system_rhs    = 0.0;
+  if (assemble_pressure_mass)
+    this->pressure_mass = 0.0;
+
+  std::vector<double>         local_solution(dofs_per_cell);
 
   std::vector<Tensor<1, dim>> previous_velocity_values(n_q);
   std::vector<Tensor<2, dim>> previous_velocity_gradients(n_q);
-  std::vector<double>         previous_pressure_values(n_q);
 
   std::vector<double>         div_phi_u(dofs_per_cell);
   std::vector<Tensor<1, dim>> phi_u(dofs_per_cell);
   std::vector<Tensor<2, dim>> grad_phi_u(dofs_per_cell);
   std::vector<double>         phi_p(dofs_per_cell);
+  std::vector<Tensor<1, dim>> grad_phi_p(dofs_per_cell);
+
+  // SUPG/PSPG test functions (u_k·∇)φ + ∇ψ of each shape function.
+  std::vector<Tensor<1, dim>> stabilization_test(dofs_per_cell);
 
-  for (const auto &cell : this->dof_handler.active_cell_iterators())
+  for (unsigned int c = 0; c < this->geometry_cache.size(); ++c)
   {
-    if (!cell->is_locally_owned()) 
-      continue;
+    const auto &cell = this->geometry_cache.cell(c);
+    const CellGeometry<dim> geometry = this->geometry_cache.geometry(c);
+    const std::vector<types::global_dof_index> &dof_indices = this->geometry_cache.cell_dof_indices(c);
 
-    fe_values.reinit(cell);
+    const double h = geometry.diameter / this->degree_velocity;
 
-    local_matrix = 0.0;
-    local_rhs    = 0.0;
+    local_matrix        = 0.0;
+    local_pressure_mass = 0.0;
+    local_rhs           = 0.0;
 
-    fe_values[u_k].get_function_values(this->solution_old, previous_velocity_values);
-    fe_values[u_k].get_function_gradients(this->solution_old, previous_velocity_gradients);
-    fe_values[p_k].get_function_values(this->solution_old, previous_pressure_values);
+    this->solution_old.extract_subvector_to(dof_indices.begin(), dof_indices.end(), local_solution.begin());
+    this->shapes.vector_values(local_solution, previous_velocity_values);
+    this->shapes.vector_gradients(local_solution, geometry.inverse_jacobian, previous_velocity_gradients);
 
     for (unsigned int q = 0; q < n_q; ++q)
     {
+      const double JxW = this->shapes.weight(q) * geometry.jacobian_determinant;
+
+      // Shape function k is nonzero only in its component: a velocity
+      // component (φ_k = ϕ_k e_c) or the pressure (ψ_k = ϕ_k).
       for (unsigned int k = 0; k < dofs_per_cell; ++k)
       {
-        div_phi_u[k]  = fe_values[u_k].divergence(k, q);
-        grad_phi_u[k] = fe_values[u_k].gradient(k, q);
-        phi_u[k]      = fe_values[u_k].value(k, q);
-        phi_p[k]      = fe_values[p_k].value(k, q);
+        const unsigned int   component = this->shapes.component(k);
+        const Tensor<1, dim> gradient  = this->shapes.gradient(k, q, geometry.inverse_jacobian);
+
+        div_phi_u[k]  = 0.0;
+        grad_phi_u[k] = 0.0;
+        phi_u[k]      = 0.0;
+        phi_p[k]      = 0.0;
+        grad_phi_p[k] = 0.0;
+
+        if (component < dim)
+        {
+          div_phi_u[k]             = gradient[component];
+          grad_phi_u[k][component] = gradient;
+          phi_u[k][component]      = this->shapes.value(k, q);
+        }
+        else
+        {
+          phi_p[k]      = this->shapes.value(k, q);
+          grad_phi_p[k] = gradient;
+        }
+      }
+
+      // SUPG/PSPG stabilization τ (R(u, p), (u·∇)v + ∇q), with the strong
+      // residual R(u, p) = (u·∇)u + ∇p. Picard freezes the advection
+      // velocity of both factors at u_k; Newton also linearizes them, which
+      // needs the residual R_k = R(u_k, p_k). In both cases τ is evaluated
+      // at u_k and its derivative is neglected, so the Newton Jacobian is
+      // exact up to the variation of τ, which is small once the iterates
+      // settle.
+      double         tau = 0.0;
+      Tensor<1, dim> previous_residual;
+      if (this->options.stabilization)
+      {
+        tau = compute_stabilization_parameter(h, previous_velocity_values[q].norm(), this->nu, 0.0);
+
+        for (unsigned int k = 0; k < dofs_per_cell; ++k)
+          stabilization_test[k] = grad_phi_u[k] * previous_velocity_values[q] +
+                                  grad_phi_p[k];
+
+        if (!picard)
+        {
+          previous_residual = previous_velocity_gradients[q] * previous_velocity_values[q];
+          for (unsigned int k = 0; k < dofs_per_cell; ++k)
+            previous_residual += local_solution[k] * grad_phi_p[k];
+        }
       }
 
       for (unsigned int i = 0; i < dofs_per_cell; ++i)
@@ -666,26 +767,59 @@ void NonLinearCorrection<dim>::assemble()
         {
           local_matrix(i, j) += this->nu 
                                 * scalar_product(grad_phi_u[i], grad_phi_u[j]) 
-                                * fe_values.JxW(q);
+                                * JxW;
 
-          local_matrix(i, j) += phi_u[j] 
-                                * transpose(previous_velocity_gradients[q]) 
-                                * phi_u[i]
-                                * fe_values.JxW(q);
+          // Newton term ((u·∇)u_k, v), dropped by the Picard linearization
+          if (!picard)
+            local_matrix(i, j) += phi_u[j] 
+                                  * transpose(previous_velocity_gradients[q]) 
+                                  * phi_u[i]
+                                  * JxW;
 
           local_matrix(i, j) += previous_velocity_values[q] 
                                 * transpose(grad_phi_u[j]) 
                                 * phi_u[i]
-                                * fe_values.JxW(q);
-
-          local_matrix(i, j) -= phi_p[j] * div_phi_u[i] * fe_values.JxW(q);
-          local_matrix(i, j) -= phi_p[i] * div_phi_u[j] * fe_values.JxW(q);
+                                * JxW;
+
+          // Grad-div stabilization: γ (∇·u, ∇·v)
+          if (gamma > 0.0)
+            local_matrix(i, j) += gamma * div_phi_u[j] * div_phi_u[i] * JxW;
+
+          // The continuity equation is written as (∇·u, q) = 0, with the
+          // same sign convention as the monolithic solver, so that the
+          // block preconditioners apply unchanged.
+          local_matrix(i, j) -= phi_p[j] * div_phi_u[i] * JxW;
+          local_matrix(i, j) += phi_p[i] * div_phi_u[j] * JxW;
+
+          if (this->options.stabilization)
+          {
+            local_matrix(i, j) += tau * stabilization_test[j] * stabilization_test[i] * JxW;
+
+            // Newton terms τ ((u·∇)u_k, (u_k·∇)v + ∇q) + τ (R_k, (u·∇)v)
+            if (!picard)
+              local_matrix(i, j) += tau 
+                                    * (previous_velocity_gradients[q] * phi_u[j] * stabilization_test[i] +
+                                       previous_residual * (grad_phi_u[i] * phi_u[j])) 
+                                    * JxW;
+          }
+
+          if (assemble_pressure_mass)
+            local_pressure_mass(i, j) += phi_p[i] * phi_p[j] / this->nu * JxW;
         }
 
-        local_rhs[i] += previous_velocity_values[q] 
-                        * transpose(previous_velocity_gradients[q])
-                        * phi_u[i] 
-                        * fe_values.JxW(q);
+        if (!picard)
+          local_rhs[i] += previous_velocity_values[q] 
+                          * transpose(previous_velocity_gradients[q])
+                          * phi_u[i] 
+                          * JxW;
+
+        // Right-hand side of the Newton terms of the stabilization:
+        // τ ((u_k·∇)u_k, (u_k·∇)v + ∇q) + τ (R_k, (u_k·∇)v)
+        if (!picard && this->options.stabilization)
+          local_rhs[i] += tau 
+                          * (previous_velocity_gradients[q] * previous_velocity_values[q] * stabilization_test[i] +
+                             previous_residual * (grad_phi_u[i] * previous_velocity_values[q])) 
+                          * JxW;
       }
     }
 
@@ -710,72 +844,298 @@ void NonLinearCorrection<dim>::assemble()
             }
         }
 
-    cell->get_dof_indices(dof_indices);
+    this->constraints.distribute_local_to_global(local_matrix,
+                                                 local_rhs,
+                                                 dof_indices,
+                                                 this->system_matrix,
+                                                 this->system_rhs);
 
-    constraints.distribute_local_to_global(local_matrix,
-                                           local_rhs,
-                                           dof_indices,
-                                           this->system_matrix,
-                                           this->system_rhs);
+    if (assemble_pressure_mass)
+      this->constraints.distribute_local_to_global(local_pressure_mass,
+                                                   dof_indices,
+                                                   this->pressure_mass);
   }
   
   this->system_matrix.compress(VectorOperation::add);
   this->system_rhs.compress(VectorOperation::add);
+  if (assemble_pressure_mass)
+    this->pressure_mass.compress(VectorOperation::add);
 }
 
 
+template <int dim>
+void NonLinearCorrection<dim>::solve_linear_system()
+{
+  SolverControl solver_control(2'000'000, 1e-6);
+
+  // The current iterate is the initial guess of the next one
+  this->solution_owned = current_iterate;
+  this->constraints.set_zero(this->solution_owned);
+
+  if (this->options.preconditioner == "augmented-lagrangian")
+  {
+    // Augmented-Lagrangian preconditioner, paired with the grad-div term.
+    // Its inner solves are iterative, so the outer solver is flexible GMRES.
+    // The matrices keep their patterns across the Newton iterations and the
+    // Reynolds numbers of a sweep: the preconditioner is built at the first
+    // solve, and later solves only recompute the values of the AMG hierarchy
+    // of the velocity block (and the pressure mass one when nu changes).
+    if (!al_preconditioner)
+    {
+      al_preconditioner = std::make_shared<PreconditionAugmentedLagrangian>();
+      al_preconditioner->set_inner_cycles(this->options.inner_cycles);
+      al_preconditioner->set_mixed_precision(this->options.mixed_precision);
+      al_preconditioner->set_hierarchy_reuse(true);
+    }
+    PreconditionAugmentedLagrangian &preconditioner = *al_preconditioner;
+    preconditioner.initialize(this->system_matrix.block(0, 0),
+                              this->system_matrix.block(1, 0),
+                              this->system_matrix.block(0, 1),
+                              this->pressure_mass.block(1, 1),
+                              this->nu,
+                              this->options.grad_div,
+                              10000,
+                              this->options.inner_tolerance,
+                              false);
+
+    if (this->options.gmres_orthogonalization == "cgs2")
+      solve_linear_system_cgs2(solver_control, preconditioner);
+    else
+    {
+      SolverFGMRES<TrilinosWrappers::MPI::BlockVector> solver(solver_control);
+      solver.solve(this->system_matrix,
+                   this->solution_owned,
+                   this->system_rhs,
+                   preconditioner);
+    }
+  }
+  else
+  {
+    typename SteadyNavierStokes<dim>::PreconditionIdentity preconditioner;
+
+    if (this->options.gmres_orthogonalization == "cgs2")
+      solve_linear_system_cgs2(solver_control, preconditioner);
+    else
+    {
+      SolverGMRES<TrilinosWrappers::MPI::BlockVector> solver(solver_control);
+      solver.solve(this->system_matrix,
+                    this->solution_owned,
+                    this->system_rhs,
+                    preconditioner);
+    }
+  }
+
+  this->constraints.distribute(this->solution_owned);
+  this->pcout << "  " << solver_control.last_step()
+              << " GMRES iterations" << std::endl;
+}
+
+template <int dim>
+template <typename PreconditionerType>
+void NonLinearCorrection<dim>::solve_linear_system_cgs2(SolverControl &solver_control,
+                                                        const PreconditionerType &preconditioner)
+{
+  SolverFGMRESCGS2 solver(solver_control);
+  solver.solve(this->system_matrix,
+               this->solution_owned,
+               this->system_rhs,
+               preconditioner);
+
+  this->pcout << "  " << solver.n_reductions() << " reductions (MGS: "
+              << solver.n_reductions_mgs() << ")" << std::endl;
+}
+
+template <int dim>
+double NonLinearCorrection<dim>::compute_residual_norm(const TrilinosWrappers::MPI::BlockVector &iterate)
+{
+  // assemble() linearizes at solution_old. With both the Newton and the
+  // Picard linearization A(u) u - b(u) is the residual of the nonlinear
+  // problem at u, so the system assembled here is also the one solved by
+  // the next iteration. On a constrained row distribute_local_to_global()
+  // writes diag_i on the matrix and diag_i g_i on the right-hand side: the
+  // row imposes u_i = g_i with the arbitrary scaling diag_i and is not an
+  // equation of the nonlinear problem, so it is zeroed and the norm only
+  // measures the residual of the unconstrained rows.
+  this->solution_old = iterate;
+  this->assemble();
+
+  this->system_matrix.vmult(residual, iterate);
+  residual -= this->system_rhs;
+  this->constraints.set_zero(residual);
+
+  return residual.l2_norm();
+}
+
 template <int dim>
 void NonLinearCorrection<dim>::solve()
 {
-  for (iter = 0; iter < maxIter; ++iter)
+  if (this->options.nonlinear_solver == "anderson")
   {
-    this->assemble();
-    double update_norm = tolerance + 1.0; 
-    
-    SolverControl solver_control(2'000'000, 1e-6);
-    SolverGMRES<TrilinosWrappers::MPI::BlockVector> solver(solver_control);
+    solve_anderson();
+    return;
+  }
 
-    typename SteadyNavierStokes<dim>::PreconditionIdentity preconditioner;
-    constraints.set_zero(this->solution_owned); 
+  const unsigned int max_iterations = this->options.newton_max_iterations;
 
-    solver.solve(this->system_matrix,
-                  this->solution_owned,
-                  this->system_rhs,
-                  preconditioner);
+  current_iterate = solution_old;
 
-    constraints.distribute(this->solution_owned);  
-    this->pcout << "  " << solver_control.last_step()
-                << " GMRES iterations" << std::endl;
+  picard = (this->options.picard_iterations > 0);
+  double residual_norm = compute_residual_norm(current_iterate);
+  const double target_residual = this->options.newton_tolerance * residual_norm;
 
-    this->solution = this->solution_owned;
+  this->pcout << "Initial nonlinear residual = " << residual_norm << std::endl;
 
-    this->new_res.reinit(this->solution);
-    this->new_res = this->solution;
-    this->new_res.sadd(1.0, -1.0, this->solution_old);
+  bool converged = (residual_norm == 0.0);
 
-    // Compute L2 norm
-    double local_sum = 0.0;
-    for (unsigned int k = 0; k < this->new_res.size(); ++k)
-      local_sum += this->new_res(k) * this->new_res(k);
+  for (iter = 0; iter < max_iterations && !converged;)
+  {
+    const bool picard_step = picard;
 
-    double global_sum = 0.0;
-    MPI_Allreduce(&local_sum, &global_sum, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
-    update_norm = std::sqrt(global_sum);
+    // Full step, from the system assembled at the current iterate
+    solve_linear_system();
+    newton_update = this->solution_owned;
+    newton_update -= current_iterate;
 
-    double residual = update_norm / this->solution.size(); // Scale-independent residual
+    // The next iteration switches to Newton after the Picard ones; the
+    // residual of the trial iterates is computed with its linearization.
+    picard = (iter + 1 < this->options.picard_iterations);
 
-    if (this->mpi_rank == 0)
-      std::cout << "Residual after update = " << residual << std::endl;
+    // Backtracking line search on the residual norm (Armijo condition)
+    double step = 1.0;
+    double trial_residual_norm = 0.0;
+    for (unsigned int k = 0;; ++k)
+    {
+      this->solution_owned = current_iterate;
+      this->solution_owned.add(step, newton_update);
+      trial_residual_norm = compute_residual_norm(this->solution_owned);
 
-    this->solution_old = this->solution;
+      if (trial_residual_norm <= (1.0 - sufficient_decrease * step) * residual_norm ||
+          k == this->options.line_search_steps)
+        break;
 
-    if (this->mpi_rank == 0)
-      std::cout << "Iteration " << iter << " completed." << std::endl;
+      step *= 0.5;
+    }
+
+    current_iterate = this->solution_owned;
+    residual_norm = trial_residual_norm;
+    ++iter;
+
+    this->pcout << (picard_step ? "Picard" : "Newton") << " iteration " << iter
+                << ": step = " << step
+                << ", residual = " << residual_norm << std::endl;
 
-    if (residual < tolerance) 
-      break;
+    converged = (residual_norm <= target_residual);
   }
-  if (iter == maxIter)
+
+  // solution_old holds the last iterate, the initial guess of a following solve()
+  this->solution = solution_old;
+
+  if (!converged)
+    this->pcout << "Nonlinear solver did not converge." << std::endl;
+}
+
+template <int dim>
+void NonLinearCorrection<dim>::solve_anderson()
+{
+  // Fixed-point iteration u_{k+1} = G(u_k), where G(u) solves the Oseen
+  // system linearized at u. Anderson mixing combines the last m images,
+  //
+  //   u_{k+1} = G(u_k) - Σ_j γ_j ΔG_j,   γ = argmin ||f_k - Σ_j γ_j ΔF_j||,
+  //
+  // with f_k = G(u_k) - u_k and ΔF_j, ΔG_j the differences of consecutive
+  // residuals and images. The coefficients of the images sum to one, so
+  // the iterates keep satisfying the Dirichlet constraints.
+  const unsigned int depth          = this->options.anderson_depth;
+  const unsigned int max_iterations = this->options.newton_max_iterations;
+
+  std::deque<TrilinosWrappers::MPI::BlockVector> residual_differences;   // ΔF_j
+  std::deque<TrilinosWrappers::MPI::BlockVector> image_differences;      // ΔG_j
+  TrilinosWrappers::MPI::BlockVector previous_residual;                  // f_{k-1}
+  TrilinosWrappers::MPI::BlockVector previous_image;                     // G(u_{k-1})
+
+  current_iterate = solution_old;
+
+  picard = true;
+  double residual_norm = compute_residual_norm(current_iterate);
+  const double target_residual = this->options.newton_tolerance * residual_norm;
+
+  this->pcout << "Initial nonlinear residual = " << residual_norm << std::endl;
+
+  bool converged = (residual_norm == 0.0);
+
+  for (iter = 0; iter < max_iterations && !converged;)
+  {
+    // Image G(u_k), from the Oseen system assembled at the current iterate
+    solve_linear_system();
+    newton_update = this->solution_owned;
+    newton_update -= current_iterate;
+
+    if (depth > 0 && iter > 0)
+    {
+      residual_differences.push_back(newton_update);
+      residual_differences.back() -= previous_residual;
+      image_differences.push_back(this->solution_owned);
+      image_differences.back() -= previous_image;
+
+      if (residual_differences.size() > depth)
+      {
+        residual_differences.pop_front();
+        image_differences.pop_front();
+      }
+    }
+
+    if (depth > 0)
+    {
+      previous_residual = newton_update;
+      previous_image    = this->solution_owned;
+    }
+
+    // Least-squares problem through its normal equations, of size m <= depth,
+    // with a small Tikhonov term against nearly dependent differences
+    const unsigned int m = residual_differences.size();
+    if (m > 0)
+    {
+      FullMatrix<double> gram(m, m);
+      Vector<double>     projection(m);
+      Vector<double>     gamma(m);
+
+      double trace = 0.0;
+      for (unsigned int i = 0; i < m; ++i)
+      {
+        projection(i) = residual_differences[i] * newton_update;
+        for (unsigned int j = 0; j <= i; ++j)
+          gram(i, j) = gram(j, i) = residual_differences[i] * residual_differences[j];
+        trace += gram(i, i);
+      }
+
+      if (trace > 0.0)
+      {
+        for (unsigned int i = 0; i < m; ++i)
+          gram(i, i) += 1e-10 * trace;
+
+        gram.gauss_jordan();
+        gram.vmult(gamma, projection);
+
+        for (unsigned int i = 0; i < m; ++i)
+          this->solution_owned.add(-gamma(i), image_differences[i]);
+      }
+    }
+
+    current_iterate = this->solution_owned;
+    residual_norm = compute_residual_norm(current_iterate);
+    ++iter;
+
+    this->pcout << "Anderson iteration " << iter
+                << " (depth " << m << ")"
+                << ": residual = " << residual_norm << std::endl;
+
+    converged = (residual_norm <= target_residual);
+  }
+
+  // solution_old holds the last iterate, the initial guess of a following solve()
+  this->solution = solution_old;
+
+  if (!converged)
     this->pcout << "Nonlinear solver did not converge." << std::endl;
 }
 
@@ -918,16 +1278,20 @@ void NonLinearCorrection<dim>::compute_lift_drag()
     MPI_Reduce(&local_lift, &total_lift, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
     MPI_Reduce(&local_drag, &total_drag, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
 
-    // Define points of interest for pressure difference
-    if constexpr (dim == 2)
+    // Define points of interest for pressure difference. They are set at
+    // the first call only: with reynolds_sweep this runs once per Re.
+    if (points_of_interest.empty())
     {
-        points_of_interest.emplace_back(0.15, 0.20);
-        points_of_interest.emplace_back(0.25, 0.20);
-    }
-    else if constexpr (dim == 3)
-    {
-        points_of_interest.emplace_back(0.45, 0.2, 0.205);
-        points_of_interest.emplace_back(0.55, 0.2, 0.205);
+        if constexpr (dim == 2)
+        {
+            points_of_interest.emplace_back(0.15, 0.20);
+            points_of_interest.emplace_back(0.25, 0.20);
+        }
+        else if constexpr (dim == 3)
+        {
+            points_of_interest.emplace_back(0.45, 0.2, 0.205);
+            points_of_interest.emplace_back(0.55, 0.2, 0.205);
+        }
     }
 
     // Containers to store pressure at points
@@ -1011,6 +1375,22 @@ void NonLinearCorrection<dim>::compute_lift_drag()
     MPI_Barrier(MPI_COMM_WORLD);
 }
 
+template <int dim>
+void NonLinearCorrection<dim>::sample_probes()
+{
+  std::vector<std::string> names;
+  for (unsigned int d = 0; d < dim; ++d)
+    names.push_back("velocity_" + std::string(1, static_cast<char>('x' + d)));
+  names.push_back("pressure");
+
+  Probes<dim> probes(this->options.probes_file);
+  probes.initialize({&this->dof_handler}, {names},
+                    (std::filesystem::path(this->get_output_directory()) / "probes.csv").string());
+  probes.sample(0.0, this->solution);
+
+  this->pcout << "Sampled the solution at " << probes.n_probes() << " probes" << std::endl;
+}
+
 template <int dim>
 std::string NonLinearCorrection<dim>::get_output_directory() const
 {
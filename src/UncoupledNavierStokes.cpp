@@ -1,4 +1,5 @@
 #include "../include/UncoupledNavierStokes.hpp"
+#include "../include/ConvectionBatch.hpp"
 
 template <unsigned int dim>
 void UncoupledNavierStokes<dim>::setup()
@@ -81,6 +82,25 @@ void UncoupledNavierStokes<dim>::setup()
     dsp_p.compress();
 
     pressure_matrix.reinit(dsp_p);
+    if (rotational)
+        pressure_mass_matrix.reinit(dsp_p);
+
+    // Owned cells and shape functions used by all the assemblers.
+    velocity_quadrature = QGaussSimplex<dim>(std::max<unsigned int>(2u, fe_velocity.degree + 1u));
+    pressure_quadrature = QGaussSimplex<dim>(std::max<unsigned int>(2u, fe_pressure.degree + 1u));
+
+    owned_cells.reinit(dof_handler_velocity, dof_handler_pressure, options.geometry_cache);
+    velocity_on_velocity_quadrature.reinit(fe_velocity, velocity_quadrature);
+    pressure_on_velocity_quadrature.reinit(fe_pressure, velocity_quadrature);
+    velocity_on_pressure_quadrature.reinit(fe_velocity, pressure_quadrature);
+    pressure_on_pressure_quadrature.reinit(fe_pressure, pressure_quadrature);
+    velocity_on_velocity_quadrature.reference_mass_matrix(reference_velocity_mass);
+
+    cylinder_faces.clear();
+    for (const auto &cell : owned_cells)
+        for (unsigned int f = 0; f < cell.velocity_cell->n_faces(); ++f)
+            if (cell.velocity_cell->face(f)->at_boundary() && cell.velocity_cell->face(f)->boundary_id() == 3)
+                cylinder_faces.emplace_back(&cell, f);
 
     old_velocity.reinit(locally_owned_velocity, locally_relevant_velocity, MPI_COMM_WORLD);
     old_old_velocity.reinit(locally_owned_velocity, locally_relevant_velocity, MPI_COMM_WORLD);
@@ -93,12 +113,132 @@ void UncoupledNavierStokes<dim>::setup()
     deltap.reinit(locally_owned_pressure, locally_relevant_pressure, MPI_COMM_WORLD);
     pressure_solution.reinit(locally_owned_pressure, locally_relevant_pressure, MPI_COMM_WORLD);
     pressure_system_rhs.reinit(locally_owned_pressure, MPI_COMM_WORLD);
+    divergence_rhs.reinit(locally_owned_pressure, MPI_COMM_WORLD);
 
     pcout << "  Number of DoFs: " << std::endl;
     pcout << "    velocity = " << dof_handler_velocity.n_dofs() << std::endl;
     pcout << "    pressure = " << dof_handler_pressure.n_dofs() << std::endl;
     pcout << "    total    = " << dof_handler_velocity.n_dofs() + dof_handler_pressure.n_dofs() << std::endl;
     pcout << "-----------------------------------------------" << std::endl;
+
+    // Initialize the probes.
+    if (!options.probes_file.empty())
+    {
+        std::vector<std::string> velocity_names;
+        for (unsigned int d = 0; d < dim; ++d)
+            velocity_names.push_back("velocity_" + std::string(1, static_cast<char>('x' + d)));
+
+        probes = std::make_unique<Probes<dim>>(options.probes_file);
+        probes->initialize({&dof_handler_velocity, &dof_handler_pressure},
+                           {velocity_names, {"pressure"}},
+                           get_output_directory() + "probes.csv");
+
+        pcout << "  Number of probes = " << probes->n_probes() << std::endl;
+        pcout << "-----------------------------------------------" << std::endl;
+    }
+}
+
+template <unsigned int dim>
+void UncoupledNavierStokes<dim>::assemble_constant_matrices()
+{
+    TimerOutput::Scope t(computing_timer, "assemble_constant_matrices");
+
+    // The mesh does not change, so the pressure Laplacian and the mass
+    // matrices are assembled here once, together with their preconditioners.
+    pressure_matrix = 0;
+    velocity_update_matrix = 0;
+    if (rotational)
+        pressure_mass_matrix = 0;
+
+    const ReferenceShapes<dim> &pressure_shapes = pressure_on_pressure_quadrature;
+
+    const unsigned int dofs_per_cell_v = fe_velocity.dofs_per_cell;
+    const unsigned int dofs_per_cell_p = fe_pressure.dofs_per_cell;
+    const unsigned int n_q = pressure_quadrature.size();
+
+    FullMatrix<double> cell_laplace(dofs_per_cell_p, dofs_per_cell_p);
+    FullMatrix<double> cell_pressure_mass(dofs_per_cell_p, dofs_per_cell_p);
+    FullMatrix<double> cell_velocity_mass(dofs_per_cell_v, dofs_per_cell_v);
+
+    std::vector<Tensor<1, dim>> grad_psi(dofs_per_cell_p);
+
+    for (const auto &cell : owned_cells)
+    {
+        const CellGeometry<dim> geometry = cell.geometry();
+        cell_laplace = 0;
+        cell_pressure_mass = 0;
+
+        for (unsigned int q = 0; q < n_q; ++q)
+        {
+            const double JxW = pressure_shapes.weight(q) * geometry.jacobian_determinant;
+
+            for (unsigned int i = 0; i < dofs_per_cell_p; ++i)
+                grad_psi[i] = pressure_shapes.gradient(i, q, geometry.inverse_jacobian);
+
+            for (unsigned int i = 0; i < dofs_per_cell_p; ++i)
+                for (unsigned int j = 0; j < dofs_per_cell_p; ++j)
+                {
+                    // Pressure Laplacian
+                    // ------
+                    // L_ij = ∫ ∇ψ_i·∇ψ_j dx
+                    // ------
+                    cell_laplace(i, j) += scalar_product(grad_psi[j], grad_psi[i]) * JxW;
+
+                    // Pressure mass
+                    // ------
+                    // ∫ ψ_i·ψ_j dx
+                    // ------
+                    cell_pressure_mass(i, j) += pressure_shapes.value(i, q) * pressure_shapes.value(j, q) * JxW;
+                }
+        }
+
+        // Velocity mass
+        // ------
+        // ∫ φ_i·φ_j dx = |det J| ∫ φ_i·φ_j dx̂
+        // ------
+        cell_velocity_mass.equ(geometry.jacobian_determinant, reference_velocity_mass);
+
+        constraints_pressure.distribute_local_to_global(cell_laplace, cell.pressure_dof_indices, pressure_matrix);
+        constraints_velocity.distribute_local_to_global(cell_velocity_mass, cell.velocity_dof_indices, velocity_update_matrix);
+        if (rotational)
+            constraints_pressure.distribute_local_to_global(cell_pressure_mass, cell.pressure_dof_indices, pressure_mass_matrix);
+    }
+
+    pressure_matrix.compress(VectorOperation::add);
+    velocity_update_matrix.compress(VectorOperation::add);
+
+    if (rotational)
+        pressure_mass_matrix.compress(VectorOperation::add);
+
+    // The matrices never change: with a direct solver they are factorized
+    // here once, and every later solve is a pair of triangular solves.
+    if (options.direct_solver != "none")
+    {
+        velocity_direct_solver.set_solver(options.direct_solver);
+        pressure_direct_solver.set_solver(options.direct_solver);
+        velocity_update_direct_solver.set_solver(options.direct_solver);
+
+        pressure_direct_solver.factorize(pressure_matrix);
+        velocity_update_direct_solver.factorize(velocity_update_matrix);
+
+        if (rotational)
+        {
+            pressure_mass_direct_solver.set_solver(options.direct_solver);
+            pressure_mass_direct_solver.factorize(pressure_mass_matrix);
+        }
+        return;
+    }
+
+    pressure_preconditioner.initialize(pressure_matrix);
+
+    // Jacobi or SSOR
+    TrilinosWrappers::PreconditionJacobi::AdditionalData data;
+    data.omega = 0.7;
+    data.n_sweeps = 5;
+    velocity_update_preconditioner.initialize(velocity_update_matrix, data);
+
+    if (rotational)
+        pressure_mass_preconditioner.initialize(pressure_mass_matrix);
 }
 
 template <unsigned int dim>
@@ -109,106 +249,116 @@ void UncoupledNavierStokes<dim>::assemble_system_velocity()
     velocity_matrix = 0;
     velocity_system_rhs = 0;
 
-    const unsigned int quad_deg = std::max<unsigned int>(2u, fe_velocity.degree + 1u);
-    QGaussSimplex<dim> quadrature_formula(quad_deg);
-
-    FEValues<dim> fe_values(fe_velocity, quadrature_formula,
-                            update_values | update_gradients |
-                                update_quadrature_points | update_JxW_values);
-
-    FEValues<dim> fe_values_pressure(fe_pressure, quadrature_formula,
-                                     update_gradients | update_quadrature_points);
+    const ReferenceShapes<dim> &velocity_shapes = velocity_on_velocity_quadrature;
+    const ReferenceShapes<dim> &pressure_shapes = pressure_on_velocity_quadrature;
 
     const unsigned int dofs_per_cell = fe_velocity.dofs_per_cell;
-    const unsigned int n_q = quadrature_formula.size();
+    const unsigned int n_q = velocity_quadrature.size();
 
-    FullMatrix<double> cell_matrix(dofs_per_cell, dofs_per_cell);
-    Vector<double> cell_rhs(dofs_per_cell);
-    std::vector<types::global_dof_index> local_indices(dofs_per_cell);
+    std::vector<double> old_local(dofs_per_cell);
+    std::vector<double> old_old_local(dofs_per_cell);
+    std::vector<double> pressure_local(fe_pressure.dofs_per_cell);
 
     std::vector<Tensor<1, dim>> old_val(n_q);
     std::vector<double> old_div(n_q);
     std::vector<Tensor<1, dim>> old_old_val(n_q);
-    std::vector<double> old_old_div(n_q);
+    std::vector<Tensor<1, dim>> u_star(n_q);
     std::vector<Tensor<1, dim>> pressure_grad(n_q);
 
-    auto cell_v = dof_handler_velocity.begin_active();
-    auto cell_p = dof_handler_pressure.begin_active();
-    const auto end_v = dof_handler_velocity.end();
+    const auto start = std::chrono::steady_clock::now();
+
+    // The matrix is computed for batches of cells at once, vectorized
+    // across the cells of the batch (see ConvectionBatch).
+    //
+    // Mass Term
+    // ------
+    // M_ij = (3/2) * (1/Δt) ∫ φ_i·φ_j dx
+    // ------
+    // Viscous
+    // ------
+    // A_ij = ∫ ν ∇φ_i:∇φ_j dx
+    // ------
+    // Convection
+    // ------
+    // N_ij(u*) = ∫ (u* φ_j)·φ_i dx
+    // ------
+    ConvectionBatch<dim> batch(fe_velocity, n_q, 0, (3.0 / 2.0) * (1. / deltat), nu, 0.0);
+
+    std::vector<FullMatrix<double>> batch_cell_matrices(batch.n_lanes,
+                                                        FullMatrix<double>(dofs_per_cell, dofs_per_cell));
+    std::vector<Vector<double>> batch_cell_rhs(batch.n_lanes, Vector<double>(dofs_per_cell));
+    std::vector<std::vector<types::global_dof_index>> batch_local_indices(batch.n_lanes,
+                                                                          std::vector<types::global_dof_index>(dofs_per_cell));
+
+    const auto flush_batch = [&]() {
+        batch.compute();
+        for (unsigned int lane = 0; lane < batch.size(); ++lane)
+        {
+            batch.distribute(lane, batch_cell_matrices[lane]);
+            constraints_velocity.distribute_local_to_global(batch_cell_matrices[lane],
+                                                            batch_cell_rhs[lane],
+                                                            batch_local_indices[lane],
+                                                            velocity_matrix,
+                                                            velocity_system_rhs);
+        }
+        batch.clear();
+    };
 
-    for (; cell_v != end_v; ++cell_v, ++cell_p)
+    for (const auto &cell : owned_cells)
     {
-        if (!cell_v->is_locally_owned())
-            continue;
-
-        fe_values.reinit(cell_v);
-        fe_values_pressure.reinit(cell_p);
+        const CellGeometry<dim> geometry = cell.geometry();
+        const unsigned int lane = batch.size();
+        FullMatrix<double> &cell_matrix = batch_cell_matrices[lane];
+        Vector<double> &cell_rhs = batch_cell_rhs[lane];
 
         cell_matrix = 0;
         cell_rhs = 0;
 
-        const auto &vel_extract = fe_values[FEValuesExtractors::Vector(0)];
-        vel_extract.get_function_values(old_velocity, old_val);
-        vel_extract.get_function_divergences(old_velocity, old_div);
-        vel_extract.get_function_values(old_old_velocity, old_old_val);
-        vel_extract.get_function_divergences(old_old_velocity, old_old_div);
+        old_velocity.extract_subvector_to(cell.velocity_dof_indices.begin(), cell.velocity_dof_indices.end(), old_local.begin());
+        old_old_velocity.extract_subvector_to(cell.velocity_dof_indices.begin(), cell.velocity_dof_indices.end(), old_old_local.begin());
+        pressure_solution.extract_subvector_to(cell.pressure_dof_indices.begin(), cell.pressure_dof_indices.end(), pressure_local.begin());
 
-        fe_values_pressure.get_function_gradients(pressure_solution, pressure_grad);
+        velocity_shapes.vector_values(old_local, old_val);
+        velocity_shapes.divergences(old_local, geometry.inverse_jacobian, old_div);
+        velocity_shapes.vector_values(old_old_local, old_old_val);
+        pressure_shapes.scalar_gradients(pressure_local, geometry.inverse_jacobian, pressure_grad);
+
+        // ------
+        // u* = 2*u^n - u^{n-1}
+        // ------
+        for (unsigned int q = 0; q < n_q; ++q)
+            u_star[q] = 2.0 * old_val[q] - old_old_val[q];
+
+        batch.add_cell(velocity_shapes, geometry.inverse_jacobian, geometry.jacobian_determinant, u_star, old_div);
 
         for (unsigned int q = 0; q < n_q; ++q)
         {
+            const double JxW = velocity_shapes.weight(q) * geometry.jacobian_determinant;
+
+            // Time dependent term
             // ------
-            // u* = 2*u^n - u^{n-1}
+            // ∫ (1/2Δt)(4u^n·φ_i- u^{n-1}·φ_i) dx
             // ------
-            const Tensor<1, dim> &u_star = 2.0 * old_val[q] - old_old_val[q]; 
+            // Pressure term
+            // ------
+            // - ∫ φ_j·∇p dx
+            // ------
+            const Tensor<1, dim> rhs_value = (1.0 / (2 * deltat)) * (4.0 * old_val[q] - old_old_val[q]) - pressure_grad[q];
 
+            // φ_i is nonzero only in its own component.
             for (unsigned int i = 0; i < dofs_per_cell; ++i)
-            {
-
-                for (unsigned int j = 0; j < dofs_per_cell; ++j)
-                {
-                    double lhs = 0.0;
-                    
-                    // Mass Term
-                    // ------
-                    // M_ij = (3/2) * (1/Δt) ∫ φ_i·φ_j dx
-                    // ------
-                    lhs += (3.0/2.0) * (1./deltat) * scalar_product(vel_extract.value(j, q), vel_extract.value(i, q));
-                    
-                    // Viscous
-                    // ------
-                    // A_ij = ∫ ν ∇φ_i:∇φ_j dx
-                    // ------
-                    lhs += nu * scalar_product(vel_extract.gradient(j, q), vel_extract.gradient(i, q));
-                    
-                    // Convection
-                    // ------
-                    // N_ij(u*) = ∫ (u* φ_j)·φ_i dx
-                    // ------
-                    lhs += (scalar_product(vel_extract.gradient(j, q) * u_star, vel_extract.value(i, q))); 
-
-                    cell_matrix(i, j) += lhs * fe_values.JxW(q);
-                }
-
-                // Time dependent term
-                // ------
-                // ∫ (1/2Δt)(4u^n·φ_i- u^{n-1}·φ_i) dx
-                // ------
-                cell_rhs(i) += (1.0/(2*deltat)) * scalar_product(4.0 * old_val[q], vel_extract.value(i, q)) * fe_values.JxW(q);
-                cell_rhs(i) -= (1.0/(2*deltat)) * scalar_product(old_old_val[q], vel_extract.value(i, q)) * fe_values.JxW(q);
-                
-                // Pressure term
-                // ------
-                // - ∫ φ_j·∇p dx
-                cell_rhs(i) -= scalar_product(pressure_grad[q], vel_extract.value(i, q)) * fe_values.JxW(q);
-            }
+                cell_rhs(i) += rhs_value[velocity_shapes.component(i)] * velocity_shapes.value(i, q) * JxW;
         }
-        cell_v->get_dof_indices(local_indices);
-        constraints_velocity.distribute_local_to_global(cell_matrix, cell_rhs,
-                                                        local_indices,
-                                                        velocity_matrix,
-                                                        velocity_system_rhs);
+        batch_local_indices[lane] = cell.velocity_dof_indices;
+
+        if (batch.full())
+            flush_batch();
     }
+    if (batch.size() > 0)
+        flush_batch();
+
+    convection_assembly_time += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    n_convection_cells += owned_cells.size();
 
     velocity_matrix.compress(VectorOperation::add);
     velocity_system_rhs.compress(VectorOperation::add);
@@ -221,20 +371,35 @@ void UncoupledNavierStokes<dim>::solve_velocity_system()
 
     TrilinosWrappers::MPI::Vector tmp(locally_owned_velocity, MPI_COMM_WORLD);
 
-    SolverControl solver_control(1000000, 1e-7 * velocity_system_rhs.l2_norm());
+    // The pattern of the velocity matrix is fixed: a direct solver only
+    // recomputes the numeric factorization.
+    if (options.direct_solver != "none")
+    {
+        velocity_direct_solver.factorize(velocity_matrix);
+        velocity_direct_solver.solve(tmp, velocity_system_rhs);
+    }
+    else
+    {
+        SolverControl solver_control(1000000, 1e-7 * velocity_system_rhs.l2_norm());
 
-    // Create and initialize preconditioner:
-    TrilinosWrappers::PreconditionSSOR prec;
-    prec.initialize(velocity_matrix);
+        // Create and initialize preconditioner:
+        TrilinosWrappers::PreconditionSSOR prec;
+        prec.initialize(velocity_matrix);
 
-    // Create GMRES solver *without* specifying any restart parameter:
-    SolverGMRES<TrilinosWrappers::MPI::Vector> solver_gmres(solver_control);
+        // Create GMRES solver *without* specifying any restart parameter:
+        SolverGMRES<TrilinosWrappers::MPI::Vector> solver_gmres(solver_control);
 
-    // Solve the linear system:
-    solver_gmres.solve(velocity_matrix, tmp, velocity_system_rhs, prec);
+        // Start from the past solutions if requested, from zero otherwise:
+        velocity_history.initial_guess(velocity_matrix, velocity_system_rhs, tmp);
 
-    if (mpi_rank == 0)
-        std::cout << "Velocity GMRES iterations: " << solver_control.last_step() << std::endl;
+        // Solve the linear system:
+        solver_gmres.solve(velocity_matrix, tmp, velocity_system_rhs, prec);
+
+        if (mpi_rank == 0)
+            std::cout << "Velocity GMRES iterations: " << solver_control.last_step() << std::endl;
+
+        velocity_history.push(tmp);
+    }
 
     // Distribute constraints (apply hanging-node constraints, Dirichlet BC, etc.):
     constraints_velocity.distribute(tmp);
@@ -247,84 +412,78 @@ void UncoupledNavierStokes<dim>::solve_velocity_system()
     velocity_solution.update_ghost_values();
 }
 template <unsigned int dim>
-void UncoupledNavierStokes<dim>::assemble_system_pressure()
+void UncoupledNavierStokes<dim>::assemble_projection_rhs()
 {
+    TimerOutput::Scope t(computing_timer, "assemble_projection_rhs");
 
-    TimerOutput::Scope t(computing_timer, "assemble_pressure");
-    pressure_matrix = 0;
-    pressure_system_rhs = 0;
-
-    const unsigned int quad_deg = std::max<unsigned int>(2u, fe_pressure.degree + 1u);
-    QGaussSimplex<dim> quad(quad_deg);
-    QGaussSimplex<dim - 1> quad_face(quad_deg);
-
-    FEValues<dim> fe_values_p(fe_pressure, quad,
-                              update_values | update_gradients |
-                                  update_quadrature_points | update_JxW_values);
+    // The right-hand sides of the pressure system, of the rotational
+    // correction and the u~ part of the one of the velocity update only
+    // depend on u~: they are built in one pass, reading the coefficients
+    // of u~ once per cell.
+    divergence_rhs = 0;
+    velocity_update_rhs = 0;
 
-    FEValues<dim> fe_values_v(fe_velocity, quad,
-                              update_values | update_gradients | update_quadrature_points);
+    const ReferenceShapes<dim> &pressure_shapes = pressure_on_pressure_quadrature;
+    const ReferenceShapes<dim> &velocity_shapes = velocity_on_pressure_quadrature;
 
-    FEFaceValues<dim> fe_face_values(fe_pressure, quad_face,
-                                     update_values | update_quadrature_points | update_JxW_values);
+    const unsigned int dofs_per_cell_v = fe_velocity.dofs_per_cell;
+    const unsigned int dofs_per_cell_p = fe_pressure.dofs_per_cell;
+    const unsigned int n_q = pressure_quadrature.size();
 
-    const unsigned int dofs_per_cell = fe_pressure.dofs_per_cell;
-    const unsigned int n_q = quad.size();
-
-    FullMatrix<double> cell_matrix(dofs_per_cell, dofs_per_cell);
-    Vector<double> cell_rhs(dofs_per_cell);
-    std::vector<types::global_dof_index> local_indices(dofs_per_cell);
+    FullMatrix<double> cell_velocity_mass(dofs_per_cell_v, dofs_per_cell_v);
+    Vector<double> cell_update_rhs(dofs_per_cell_v);
+    Vector<double> cell_divergence_rhs(dofs_per_cell_p);
 
+    std::vector<double> velocity_local(dofs_per_cell_v);
     std::vector<double> div_u_tilde(n_q);
 
-    auto cell_p = dof_handler_pressure.begin_active();
-    auto cell_v = dof_handler_velocity.begin_active();
-    const auto end_p = dof_handler_pressure.end();
-
-    for (; cell_p != end_p; ++cell_p, ++cell_v)
+    for (const auto &cell : owned_cells)
     {
-        if (!cell_p->is_locally_owned())
-            continue;
-        fe_values_p.reinit(cell_p);
-        fe_values_v.reinit(cell_v);
+        const CellGeometry<dim> geometry = cell.geometry();
+        cell_divergence_rhs = 0;
 
-        cell_matrix = 0;
-        cell_rhs = 0;
-
-        const auto &vel_extract = fe_values_v[FEValuesExtractors::Vector(0)];
-        vel_extract.get_function_divergences(velocity_solution, div_u_tilde);
+        velocity_solution.extract_subvector_to(cell.velocity_dof_indices.begin(), cell.velocity_dof_indices.end(), velocity_local.begin());
+        velocity_shapes.divergences(velocity_local, geometry.inverse_jacobian, div_u_tilde);
 
+        // Divergence
+        // ------
+        // ∫ div(u~)ψ_i dx
+        // ------
         for (unsigned int q = 0; q < n_q; ++q)
         {
-            const double JxW = fe_values_p.JxW(q);
-            for (unsigned int i = 0; i < dofs_per_cell; ++i)
-            {
-
-                for (unsigned int j = 0; j < dofs_per_cell; ++j)
-                {
-                    // LSH
-                    // ------
-                    // L_ij = ∫ ∇ψ_i·∇ψ_j dx
-                    // ------
-                    cell_matrix(i, j) += scalar_product(fe_values_p.shape_grad(j, q), fe_values_p.shape_grad(i, q)) * JxW;
-                }
-                
-                // RHS
-                // ------
-                // - (3/2) * (1/Δt) ∫ div(u~)ψ_i dx
-                cell_rhs(i) -= 3.0 / (2.0 * deltat) * (div_u_tilde[q] * fe_values_p.shape_value(i, q)) * JxW;
-            }
+            const double JxW = pressure_shapes.weight(q) * geometry.jacobian_determinant;
+            for (unsigned int i = 0; i < dofs_per_cell_p; ++i)
+                cell_divergence_rhs(i) += div_u_tilde[q] * pressure_shapes.value(i, q) * JxW;
         }
 
-        cell_p->get_dof_indices(local_indices);
-        constraints_pressure.distribute_local_to_global(cell_matrix, cell_rhs,
-                                                        local_indices,
-                                                        pressure_matrix,
-                                                        pressure_system_rhs);
+        // Velocity update
+        // ------
+        // ∫ u~·φ_i dx = Σ_j M_ij u~_j
+        // ------
+        // u~ lies in the velocity space, so the local mass matrix gives the
+        // term exactly; it also carries the Dirichlet data of the matrix
+        // assembled in assemble_constant_matrices() to the right-hand side.
+        cell_velocity_mass.equ(geometry.jacobian_determinant, reference_velocity_mass);
+        cell_update_rhs = 0;
+        for (unsigned int i = 0; i < dofs_per_cell_v; ++i)
+            for (unsigned int j = 0; j < dofs_per_cell_v; ++j)
+                cell_update_rhs(i) += cell_velocity_mass(i, j) * velocity_local[j];
+
+        constraints_pressure.distribute_local_to_global(cell_divergence_rhs, cell.pressure_dof_indices, divergence_rhs);
+        constraints_velocity.distribute_local_to_global(cell_update_rhs,
+                                                        cell.velocity_dof_indices,
+                                                        velocity_update_rhs,
+                                                        cell_velocity_mass);
     }
 
-    pressure_matrix.compress(VectorOperation::add);
-    pressure_system_rhs.compress(VectorOperation::add);
+    divergence_rhs.compress(VectorOperation::add);
+    velocity_update_rhs.compress(VectorOperation::add);
+
+    // RHS
+    // ------
+    // - (3/2) * (1/Δt) ∫ div(u~)ψ_i dx
+    // ------
+    pressure_system_rhs.equ(-3.0 / (2.0 * deltat), divergence_rhs);
 }
 
 template <unsigned int dim>
@@ -333,16 +492,23 @@ void UncoupledNavierStokes<dim>::solve_pressure_system()
     TimerOutput::Scope t(computing_timer, "solve_pressure");
 
     TrilinosWrappers::MPI::Vector tmp(locally_owned_pressure, MPI_COMM_WORLD);
-    SolverControl solver_control(2000000, 1e-7 * pressure_system_rhs.l2_norm());
 
-    TrilinosWrappers::PreconditionIC prec;
-    prec.initialize(pressure_matrix);
+    if (options.direct_solver != "none")
+        pressure_direct_solver.solve(tmp, pressure_system_rhs);
+    else
+    {
+        SolverControl solver_control(2000000, 1e-7 * pressure_system_rhs.l2_norm());
 
-    SolverCG<TrilinosWrappers::MPI::Vector> solver_cg(solver_control);
-    solver_cg.solve(pressure_matrix, tmp, pressure_system_rhs, prec);
+        pressure_history.initial_guess(pressure_matrix, pressure_system_rhs, tmp);
 
-    if (mpi_rank == 0)
-        std::cout << "Pressure CG iterations: " << solver_control.last_step() << std::endl;
+        SolverCG<TrilinosWrappers::MPI::Vector> solver_cg(solver_control);
+        solver_cg.solve(pressure_matrix, tmp, pressure_system_rhs, pressure_preconditioner);
+
+        if (mpi_rank == 0)
+            std::cout << "Pressure CG iterations: " << solver_control.last_step() << std::endl;
+
+        pressure_history.push(tmp);
+    }
 
     constraints_pressure.distribute(tmp);
     deltap = tmp;
@@ -356,79 +522,46 @@ void UncoupledNavierStokes<dim>::update_velocity()
 {
     TimerOutput::Scope t(computing_timer, "assemble_update");
 
-    velocity_update_matrix = 0;
-    velocity_update_rhs = 0;
-
-    const unsigned int quad_deg = std::max<unsigned int>(2u, fe_velocity.degree + 1u);
-    QGaussSimplex<dim> quad(quad_deg);
-
-    FEValues<dim> fe_values_vel(fe_velocity, quad,
-                                update_values | update_gradients |
-                                    update_quadrature_points | update_JxW_values);
-
-    FEValues<dim> fe_values_p(fe_pressure, quad,
-                              update_gradients | update_quadrature_points);
+    // The matrix is assembled once in assemble_constant_matrices(), and
+    // the u~ part of the right-hand side in assemble_projection_rhs():
+    // only the term with the pressure increment is added here.
+    const ReferenceShapes<dim> &velocity_shapes = velocity_on_velocity_quadrature;
+    const ReferenceShapes<dim> &pressure_shapes = pressure_on_velocity_quadrature;
 
     const unsigned int dofs_per_cell = fe_velocity.dofs_per_cell;
-    const unsigned int n_q = quad.size();
+    const unsigned int n_q = velocity_quadrature.size();
 
-    FullMatrix<double> cell_matrix(dofs_per_cell, dofs_per_cell);
     Vector<double> cell_rhs(dofs_per_cell);
-    std::vector<types::global_dof_index> local_indices(dofs_per_cell);
 
-    std::vector<Tensor<1, dim>> u_tilde_vals(n_q);
+    std::vector<double> pressure_local(fe_pressure.dofs_per_cell);
     std::vector<Tensor<1, dim>> grad_delta_p(n_q);
 
-    auto cell_v = dof_handler_velocity.begin_active();
-    auto cell_p = dof_handler_pressure.begin_active();
-    const auto end_v = dof_handler_velocity.end();
-
-    for (; cell_v != end_v; ++cell_v, ++cell_p)
+    for (const auto &cell : owned_cells)
     {
-        if (!cell_v->is_locally_owned())
-            continue;
-
-        fe_values_vel.reinit(cell_v);
-        fe_values_p.reinit(cell_p);
-
-        cell_matrix = 0;
+        const CellGeometry<dim> geometry = cell.geometry();
         cell_rhs = 0;
 
-        const auto &vel_extract = fe_values_vel[FEValuesExtractors::Vector(0)];
-        vel_extract.get_function_values(velocity_solution, u_tilde_vals);
-
-        fe_values_p.get_function_gradients(deltap, grad_delta_p);
+        deltap.extract_subvector_to(cell.pressure_dof_indices.begin(), cell.pressure_dof_indices.end(), pressure_local.begin());
+        pressure_shapes.scalar_gradients(pressure_local, geometry.inverse_jacobian, grad_delta_p);
 
         for (unsigned int q = 0; q < n_q; ++q)
         {
-            const double JxW = fe_values_vel.JxW(q);
+            const double JxW = velocity_shapes.weight(q) * geometry.jacobian_determinant;
 
+            // φ_i = ϕ_i e_{c_i} is nonzero only in its own component c_i.
             for (unsigned int i = 0; i < dofs_per_cell; ++i)
             {
-
-                for (unsigned int j = 0; j < dofs_per_cell; ++j)
-                {
-                    // ------
-                    // L_ij = ∫ φ_i·φ_j dx
-                    // ------
-                    cell_matrix(i, j) += scalar_product(vel_extract.value(i, q), vel_extract.value(j, q)) * JxW;
-                }
                 // RHS
                 // ------
-                // ∫ u~·φ_i dx - (2/3) Δt ∫ ∇δp·φ_i dx
+                // - (2/3) Δt ∫ ∇δp·φ_i dx
                 // ------
-                cell_rhs(i) += u_tilde_vals[q] * vel_extract.value(i, q) * JxW;
-                cell_rhs(i) -= (2.0 / 3.0) * deltat * grad_delta_p[q] * vel_extract.value(i, q) * JxW;
+                cell_rhs(i) -= (2.0 / 3.0) * deltat * grad_delta_p[q][velocity_shapes.component(i)] *
+                               velocity_shapes.value(i, q) * JxW;
             }
         }
 
-        cell_v->get_dof_indices(local_indices);
-        constraints_velocity.distribute_local_to_global(cell_matrix, cell_rhs,
-                                                        local_indices,
-                                                        velocity_update_matrix,
-                                                        velocity_update_rhs);
+        constraints_velocity.distribute_local_to_global(cell_rhs, cell.velocity_dof_indices, velocity_update_rhs);
     }
-    velocity_update_matrix.compress(VectorOperation::add);
     velocity_update_rhs.compress(VectorOperation::add);
 }
 
@@ -439,22 +572,20 @@ void UncoupledNavierStokes<dim>::solve_update_velocity_system()
     TimerOutput::Scope t(computing_timer, "solve_update");
 
     TrilinosWrappers::MPI::Vector tmp(locally_owned_velocity, MPI_COMM_WORLD);
-    SolverControl solver_control(2000, 1e-7 * velocity_update_rhs.l2_norm());
-
-    // Jacobi or SSOR
-    TrilinosWrappers::PreconditionJacobi::AdditionalData data;
-    data.omega = 0.7;
-    data.n_sweeps = 5;
 
-    TrilinosWrappers::PreconditionJacobi prec;
-    prec.initialize(velocity_update_matrix, data);
+    if (options.direct_solver != "none")
+        velocity_update_direct_solver.solve(tmp, velocity_update_rhs);
+    else
+    {
+        SolverControl solver_control(2000, 1e-7 * velocity_update_rhs.l2_norm());
 
-    SolverCG<TrilinosWrappers::MPI::Vector> solver_cg(solver_control);
+        SolverCG<TrilinosWrappers::MPI::Vector> solver_cg(solver_control);
 
-    solver_cg.solve(velocity_update_matrix, tmp, velocity_update_rhs, prec);
+        solver_cg.solve(velocity_update_matrix, tmp, velocity_update_rhs, velocity_update_preconditioner);
 
-    if (mpi_rank == 0)
-        std::cout << "Velocity update CG iters: " << solver_control.last_step() << std::endl;
+        if (mpi_rank == 0)
+            std::cout << "Velocity update CG iters: " << solver_control.last_step() << std::endl;
+    }
 
     constraints_velocity.distribute(tmp);
     update_velocity_solution = tmp;
@@ -507,6 +638,7 @@ template <unsigned int dim>
 void UncoupledNavierStokes<dim>::run()
 {
     setup();
+    assemble_constant_matrices();
 
     {
         TrilinosWrappers::MPI::Vector tmp(locally_owned_velocity, MPI_COMM_WORLD);
@@ -545,8 +677,9 @@ void UncoupledNavierStokes<dim>::run()
         assemble_system_velocity();
         solve_velocity_system();
 
-        // 2) Pressure
-        assemble_system_pressure();
+        // 2) Pressure (its right-hand side is built together with the
+        //    u~ dependent parts of steps 3 and 4)
+        assemble_projection_rhs();
         solve_pressure_system();
 
         // 3) Velocity update
@@ -562,8 +695,18 @@ void UncoupledNavierStokes<dim>::run()
 
         compute_lift_drag();
 
+        if (probes)
+            probes->sample(time, std::vector<const TrilinosWrappers::MPI::Vector *>{
+                                     &update_velocity_solution, &pressure_solution});
+
         output_results();
     }
+
+    // Throughput of the velocity matrix assembly, over all processes.
+    const double cells = Utilities::MPI::sum(static_cast<double>(n_convection_cells), MPI_COMM_WORLD);
+    const double assembly_time = Utilities::MPI::max(convection_assembly_time, MPI_COMM_WORLD);
+    pcout << "Velocity assembly: " << cells / assembly_time << " cells/s ("
+          << convection_batch_kernel_name(dim, degree_velocity) << " kernel)" << std::endl;
 }
 
 template <unsigned int dim>
@@ -606,68 +749,52 @@ void UncoupledNavierStokes<dim>::compute_lift_drag()
     double coefficient = 2.0 / (rho * u_mean * u_mean * D);
 
     // -------------------------------------------------
-    // 2) Loop over cells and faces to integrate traction
+    // 2) Loop over the cylinder faces (listed in setup) to integrate traction
     // -------------------------------------------------
-    auto cell_v = dof_handler_velocity.begin_active();
-    auto cell_p = dof_handler_pressure.begin_active();
-    const auto end_v = dof_handler_velocity.end();
-
-    for (; cell_v != end_v; ++cell_v, ++cell_p)
+    for (const auto &[cell, f] : cylinder_faces)
     {
-        // Only integrate on locally owned cells
-        if (!cell_v->is_locally_owned())
-            continue;
+        // Reinit face-values for velocity and pressure
+        fe_face_values_velocity.reinit(cell->velocity_cell, f);
+        fe_face_values_pressure.reinit(cell->pressure_cell, f);
 
-        // Loop over faces
-        for (unsigned int f = 0; f < GeometryInfo<dim>::faces_per_cell; ++f)
-        {
-            // Check boundary condition ID
-            if (cell_v->face(f)->at_boundary() && (cell_v->face(f)->boundary_id() == 3))
-            {
-                // Reinit face-values for velocity and pressure
-                fe_face_values_velocity.reinit(cell_v, f);
-                fe_face_values_pressure.reinit(cell_p, f);
+        // Extract velocity gradients
+        fe_face_values_velocity[FEValuesExtractors::Vector(0)]
+            .get_function_gradients(velocity_solution, velocity_gradients);
 
-                // Extract velocity gradients
-                fe_face_values_velocity[FEValuesExtractors::Vector(0)]
-                    .get_function_gradients(velocity_solution, velocity_gradients);
+        // Extract pressure values
+        fe_face_values_pressure[FEValuesExtractors::Scalar(0)]
+            .get_function_values(pressure_solution, pressure_values);
 
-                // Extract pressure values
-                fe_face_values_pressure[FEValuesExtractors::Scalar(0)]
-                    .get_function_values(pressure_solution, pressure_values);
-
-                for (unsigned int q = 0; q < n_face_q_points; ++q)
-                {
-                    const double p = pressure_values[q];
-                    const Tensor<2, dim> grad_u = velocity_gradients[q];
-                    const Tensor<1, dim> normal_vec = fe_face_values_velocity.normal_vector(q);
-                    const double JxW = fe_face_values_velocity.JxW(q);
-
-                    // Build fluid_stress = -p I + 2 nu e(u)
-                    // (if nu is kinematic viscosity, multiply by rho if you want μ=ρν)
-                    Tensor<2, dim> fluid_stress;
-                    // First, set diagonal entries to -p
-                    for (unsigned int d = 0; d < dim; ++d)
-                        fluid_stress[d][d] = -p;
-
-                    // Add the viscous part = 2 nu sym_grad_u
-                    for (unsigned int i = 0; i < dim; ++i)
-                        for (unsigned int j = 0; j < dim; ++j)
-                            fluid_stress[i][j] += nu * (grad_u[i][j] + grad_u[j][i]);
-
-                    // Traction = stress * normal
-                    const Tensor<1, dim> traction = fluid_stress * normal_vec;
-
-                    // Multiply by area element
-                    const Tensor<1, dim> force_contribution = traction * JxW;
-
-                    // x-component => drag, y-component => lift
-                    local_drag += -coefficient * force_contribution[0];
-                    local_lift += coefficient * force_contribution[1];
-                } // q loop
-            } // boundary check
-        } // face loop
-    } // cell loop
+        for (unsigned int q = 0; q < n_face_q_points; ++q)
+        {
+            const double p = pressure_values[q];
+            const Tensor<2, dim> grad_u = velocity_gradients[q];
+            const Tensor<1, dim> normal_vec = fe_face_values_velocity.normal_vector(q);
+            const double JxW = fe_face_values_velocity.JxW(q);
+
+            // Build fluid_stress = -p I + 2 nu e(u)
+            // (if nu is kinematic viscosity, multiply by rho if you want μ=ρν)
+            Tensor<2, dim> fluid_stress;
+            // First, set diagonal entries to -p
+            for (unsigned int d = 0; d < dim; ++d)
+                fluid_stress[d][d] = -p;
+
+            // Add the viscous part = 2 nu sym_grad_u
+            for (unsigned int i = 0; i < dim; ++i)
+                for (unsigned int j = 0; j < dim; ++j)
+                    fluid_stress[i][j] += nu * (grad_u[i][j] + grad_u[j][i]);
+
+            // Traction = stress * normal
+            const Tensor<1, dim> traction = fluid_stress * normal_vec;
+
+            // Multiply by area element
+            const Tensor<1, dim> force_contribution = traction * JxW;
+
+            // x-component => drag, y-component => lift
+            local_drag += -coefficient * force_contribution[0];
+            local_lift += coefficient * force_contribution[1];
+        } // q loop
+    } // face loop
 
     // -------------------------------------------------
     // 3) MPI: sum up partial forces to rank 0
@@ -811,120 +938,29 @@ void UncoupledNavierStokes<dim>::pressure_update(const bool rotational)
     // We must project div(u_tilde) onto the same FE space as p.
     // -------------------------
 
-    // 1) Build an L2 mass matrix for the pressure FE space
-    TrilinosWrappers::SparseMatrix mass_matrix;
-    {
-        TrilinosWrappers::SparsityPattern dsp_p(locally_owned_pressure, MPI_COMM_WORLD);
-        DoFTools::make_sparsity_pattern(dof_handler_pressure,
-                                        dsp_p,
-                                        constraints_pressure,
-                                        /*keep_constrained_dofs*/ false);
-        dsp_p.compress();
-        mass_matrix.reinit(dsp_p);
-    }
-    mass_matrix = 0.0;
-
-    // 2) Build the RHS for the L2-projection of div(u_tilde)
-    TrilinosWrappers::MPI::Vector rhs(locally_owned_pressure, MPI_COMM_WORLD);
-    rhs = 0.0;
-
-    const unsigned int quad_deg = std::max<unsigned int>(2u, fe_pressure.degree + 1u);
-    QGaussSimplex<dim> quadrature_formula(quad_deg);
-
-    FEValues<dim> fe_values_p(fe_pressure,
-                              quadrature_formula,
-                              update_values | update_quadrature_points | update_JxW_values);
-
-    FEValues<dim> fe_values_v(fe_velocity,
-                              quadrature_formula,
-                              update_values | update_gradients | update_quadrature_points);
-
-    const unsigned int n_q = quadrature_formula.size();
-    const unsigned int dofs_per_cell_p = fe_pressure.dofs_per_cell;
-
-    FullMatrix<double> cell_mass(dofs_per_cell_p, dofs_per_cell_p);
-    Vector<double> cell_rhs(dofs_per_cell_p);
-    std::vector<types::global_dof_index> local_indices(dofs_per_cell_p);
-
-    // To read the velocity divergence:
-    std::vector<double> local_div_u_tilde(n_q);
-
-    // Extractor for the velocity field in the velocity FE:
-    const FEValuesExtractors::Vector velocity_extract(0);
-
-    // Loop over cells of the pressure and velocity DoFHandlers in parallel
-    auto cell_p = dof_handler_pressure.begin_active();
-    auto cell_v = dof_handler_velocity.begin_active();
-    const auto end_p = dof_handler_pressure.end();
-
-    for (; cell_p != end_p; ++cell_p, ++cell_v)
-    {
-        if (!cell_p->is_locally_owned())
-            continue;
-
-        fe_values_p.reinit(cell_p);
-        fe_values_v.reinit(cell_v);
-
-        // Get div(u_tilde) at quadrature points
-        fe_values_v[velocity_extract].get_function_divergences(velocity_solution, local_div_u_tilde);
-
-        cell_mass = 0.0;
-        cell_rhs = 0.0;
-
-        cell_p->get_dof_indices(local_indices);
-
-        for (unsigned int q = 0; q < n_q; ++q)
-        {
-            const double div_val = local_div_u_tilde[q];
-            const double JxW = fe_values_p.JxW(q);
-
-            for (unsigned int i = 0; i < dofs_per_cell_p; ++i)
-            {
-                for (unsigned int j = 0; j < dofs_per_cell_p; ++j)
-                {
-                    // Mass matrix contribution
-                    // ------
-                    // ∫ ψ_i·ψ_j dx
-                    // ------
-                    cell_mass(i, j) += (fe_values_p.shape_value(i, q) * fe_values_p.shape_value(j, q)) * JxW;
-                }
-                // RHS 
-                // ------
-                // ∫ div(u~) ψ_i dx
-                // ------
-                cell_rhs(i) += (div_val * fe_values_p.shape_value(i, q)) * JxW;
-            }
-        }
-
-        // Add local contributions to global mass matrix & RHS
-        constraints_pressure.distribute_local_to_global(cell_mass,
-                                                        cell_rhs,
-                                                        local_indices,
-                                                        mass_matrix,
-                                                        rhs);
-    } // end cell loop
-
-    mass_matrix.compress(VectorOperation::add);
-    rhs.compress(VectorOperation::add);
-
-    // 3) Solve M * (divProj) = rhs for the L2-projection of div(u_tilde)
+    // 1) Solve M * (divProj) = ∫ div(u~) ψ_i dx for the L2-projection of
+    //    div(u_tilde). The mass matrix is assembled once and the
+    //    right-hand side in assemble_projection_rhs().
     TrilinosWrappers::MPI::Vector div_projected(locally_owned_pressure, MPI_COMM_WORLD);
 
+    if (options.direct_solver != "none")
+    {
+        pressure_mass_direct_solver.solve(div_projected, divergence_rhs);
+        constraints_pressure.distribute(div_projected);
+    }
+    else
     {
-        SolverControl solver_control(2000, 1e-7 * rhs.l2_norm());
+        SolverControl solver_control(2000, 1e-7 * divergence_rhs.l2_norm());
         SolverCG<TrilinosWrappers::MPI::Vector> solver_cg(solver_control);
 
-        TrilinosWrappers::PreconditionIC prec;
-        prec.initialize(mass_matrix);
-
-        solver_cg.solve(mass_matrix, div_projected, rhs, prec);
+        solver_cg.solve(pressure_mass_matrix, div_projected, divergence_rhs, pressure_mass_preconditioner);
         constraints_pressure.distribute(div_projected);
 
         if (mpi_rank == 0)
             std::cout << "Pressure update CG iterations: " << solver_control.last_step() << std::endl;
     }
 
-    // 4) Now apply the update:
+    // 2) Now apply the update:
     // p^{n+1} = p^n + Δp - ν * div_projected
     // (The user formula does not have a Δt factor, but add it if your scheme needs it.)
     pressure_solution.add(deltap);             // p^{n+1} = p^n + Δp
@@ -18,7 +18,8 @@ int main(int argc, char *argv[])
         std::cout << "Welcome to the Navier-Stokes solver" << std::endl;
     }
 
-    ConfigReader configReader;
+    // The parameters file can be passed as first argument (default: ../parameters.config).
+    ConfigReader configReader = (argc > 1) ? ConfigReader(argv[1]) : ConfigReader();
 
     std::filesystem::path mesh2DPath = configReader.getMesh2DPath();
     std::filesystem::path mesh3DPath = configReader.getMesh3DPath();
@@ -28,6 +29,12 @@ int main(int argc, char *argv[])
     double timeStep = configReader.getTimeStep();
     double Re = configReader.getRe();
 
+    SolverOptions solverOptions2D = configReader.getSolverOptions();
+    solverOptions2D.probes_file = configReader.getProbes2DPath().string();
+
+    SolverOptions solverOptions3D = configReader.getSolverOptions();
+    solverOptions3D.probes_file = configReader.getProbes3DPath().string();
+
     int choice = 0;
 
     if (mpi_rank == 0)
@@ -62,38 +69,38 @@ int main(int argc, char *argv[])
     case 1:
     {
         if (mpi_rank == 0) std::cout << "Solving the Steady Navier-Stokesm Problem 2D" << std::endl;
-        SteadyNavierStokes<2> steadyNavierStokes2D(mesh2DPath, degreeVelocity, degreePressure , Re);
+        SteadyNavierStokes<2> steadyNavierStokes2D(mesh2DPath, degreeVelocity, degreePressure , Re, solverOptions2D);
         steadyNavierStokes2D.run_full_problem_pipeline();
         break;
     }
     case 2:
     {
         if (mpi_rank == 0) std::cout << "Solving the Steady Navier-Stokesm Problem 3D" << std::endl;
-        SteadyNavierStokes<3> steadyNavierStokes3D(mesh3DPath, degreeVelocity, degreePressure , Re);
+        SteadyNavierStokes<3> steadyNavierStokes3D(mesh3DPath, degreeVelocity, degreePressure , Re, solverOptions3D);
         steadyNavierStokes3D.run_full_problem_pipeline();
         break;
     }
     case 3:
     {
-        MonolithicNavierStokes<2> monolithicNavierStokes(mesh2DPath, degreeVelocity, degreePressure, simulationPeriod, timeStep, Re);
+        MonolithicNavierStokes<2> monolithicNavierStokes(mesh2DPath, degreeVelocity, degreePressure, simulationPeriod, timeStep, Re, solverOptions2D);
         monolithicNavierStokes.run();
         break;
     }
     case 4:
     {
-        MonolithicNavierStokes<3> monolithicNavierStokes(mesh3DPath, degreeVelocity, degreePressure, simulationPeriod, timeStep, Re);
+        MonolithicNavierStokes<3> monolithicNavierStokes(mesh3DPath, degreeVelocity, degreePressure, simulationPeriod, timeStep, Re, solverOptions3D);
         monolithicNavierStokes.run();
         break;
     }
     case 5:
     {
-        UncoupledNavierStokes<2> uncoupledNavierStokes(mesh2DPath, degreeVelocity, degreePressure, simulationPeriod, timeStep, Re);
+        UncoupledNavierStokes<2> uncoupledNavierStokes(mesh2DPath, degreeVelocity, degreePressure, simulationPeriod, timeStep, Re, solverOptions2D);
         uncoupledNavierStokes.run();
         break;
     }
     case 6:
     {
-        UncoupledNavierStokes<3> uncoupledNavierStokes(mesh3DPath, degreeVelocity, degreePressure, simulationPeriod, timeStep, Re);
+        UncoupledNavierStokes<3> uncoupledNavierStokes(mesh3DPath, degreeVelocity, degreePressure, simulationPeriod, timeStep, Re, solverOptions3D);
         uncoupledNavierStokes.run();
         break; 
     }